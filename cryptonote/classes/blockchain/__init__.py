@@ -101,19 +101,19 @@ class Transaction:
                 )
 
         # Parse the outputs.
+        # Outputs created since the BulletproofPlus fork are tagged with a view tag.
         self.outputs: List[AbstractOutput] = []
         for o in range(len(json["vout"])):
+            target: Dict[str, Any] = json["vout"][o]["target"]
+            key: bytes = bytes.fromhex(
+                target["tagged_key"]["key"] if "tagged_key" in target else target["key"]
+            )
             if "gen" in json["vin"][0]:
-                self.outputs.append(
-                    MinerOutput(
-                        bytes.fromhex(json["vout"][o]["target"]["key"]),
-                        json["vout"][o]["amount"],
-                    )
-                )
+                self.outputs.append(MinerOutput(key, json["vout"][o]["amount"]))
             else:
                 self.outputs.append(
                     Output(
-                        bytes.fromhex(json["vout"][o]["target"]["key"]),
+                        key,
                         bytes.fromhex(json["rct_signatures"]["ecdhInfo"][o]["amount"]),
                         bytes.fromhex(json["rct_signatures"]["outPk"][o]),
                     )
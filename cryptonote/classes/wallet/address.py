@@ -1,17 +1,17 @@
 """Address file. Handles address encoding and decoding."""
 
 # Types.
-from typing import Tuple, Optional, Any
+from typing import Tuple, List, Optional, Any
 
-# Keccak hash function.
-from Cryptodome.Hash import keccak
+# Native Base58 address codec.
+from cryptonote.lib.monero_rct.c_monero_rct import (
+    encode_addresses_many,
+    decode_addresses_many,
+)
 
 # Crypto class.
 from cryptonote.crypto.crypto import Crypto
 
-# Base58 Character Set.
-BASE58: str = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz"
-
 # AddressError.
 class AddressError(Exception):
     """AddressError Exception. Used when an invalid address is parsed."""
@@ -28,8 +28,12 @@ class Address:
         payment_id: Optional[bytes] = None,
         network_byte: Optional[bytes] = None,
         address: Optional[str] = None,
+        decoded: bool = False,
     ) -> None:
-        """Converts a ViewKey and a SpendKey into an address."""
+        """
+        Converts a ViewKey and a SpendKey into an address.
+        decoded marks an address override the native codec already decoded and checked.
+        """
 
         # Verify the data lengths
         if len(crypto.network_bytes) not in {2, 3}:
@@ -46,16 +50,18 @@ class Address:
         self.spend_key: bytes = key_pair[1]
         self.payment_id: Optional[bytes] = payment_id
 
-        # If we were passed in an address, verify it against the regex.
+        # If we were passed in an address, verify it against the regex unless decoded.
         if address is not None:
             # Require a network byte was also specified.
             if network_byte is None:
-                raise Exception("Address parsed without a specified network byte.")
+                raise AddressError("Address parsed without a specified network byte.")
 
-            if (not crypto.address_regex.match(address)) and (
-                not crypto.integrated_address_regex.match(address)
+            if (
+                (not decoded)
+                and (not crypto.address_regex.match(address))
+                and (not crypto.integrated_address_regex.match(address))
             ):
-                raise Exception("Invalid address used in constructor override.")
+                raise AddressError("Invalid address used in constructor override.")
 
             # Set the network byte, address type, and address. Then return.
             self.network = network_byte
@@ -79,118 +85,94 @@ class Address:
             if self.network not in crypto.network_bytes:
                 raise Exception("Address doesn't have a valid network byte.")
 
-        # Get the data to be encoded.
-        data: bytes = self.network
-        if (self.payment_id is not None) and crypto.payment_id_leading:
-            data += self.payment_id
-        data += self.spend_key + self.view_key
-        if (self.payment_id is not None) and (not crypto.payment_id_leading):
-            data += self.payment_id
-
-        # Add the checksum.
-        checksum_hash: Any = keccak.new(digest_bits=256)
-        checksum_hash.update(data)
-        data += checksum_hash.digest()[0:4]
-
-        # Convert the bytes to Base58.
-        result: str = ""
-        for i in range(0, len(data), 8):
-            block: bytes = data[i : i + 8]
-            blockInt: int = int.from_bytes(block, byteorder="big")
-            blockStr: str = ""
-
-            remainder: int
-            while blockInt > 0:
-                remainder = blockInt % 58
-                blockInt = blockInt // 58
-                blockStr += BASE58[remainder]
-
-            # Pad the block as needed.
-            if len(block) == 8:
-                while len(blockStr) < 11:
-                    blockStr += BASE58[0]
-            elif len(block) == 5:
-                while len(blockStr) < 7:
-                    blockStr += BASE58[0]
-
-            result += blockStr[::-1]
-
-        # Set the address.
-        self.address: str = result
+        # Encode the address, with its checksum, natively.
+        self.address: str = encode_addresses_many(
+            [
+                (
+                    self.network,
+                    self.spend_key,
+                    self.view_key,
+                    b"" if self.payment_id is None else self.payment_id,
+                )
+            ],
+            crypto.payment_id_leading,
+            1,
+        )[0]
 
     @staticmethod
-    def parse(crypto: Crypto, address: str) -> Any:
+    def from_decoded(
+        crypto: Crypto,
+        address: str,
+        decoded: Optional[Tuple[bytes, bytes, bytes, bytes]],
+    ) -> Any:
         """
-        Parse an address and extract the contained info.
-        Raises AddressError if it fails to parse the address.
+        Create an Address from its result from decode_addresses_many.
+        Raises AddressError if it didn't decode or isn't valid for this coin.
         """
 
-        # Check the address against the regex.
-        if (not crypto.address_regex.match(address)) and (
-            not crypto.integrated_address_regex.match(address)
-        ):
+        # Base58, length, and checksum.
+        if decoded is None:
             raise AddressError("Invalid address.")
+        network_byte, spend_key, view_key, payment_id_bytes = decoded
 
-        # Convert the Base58 to bytes.
-        data: bytes = bytes()
-        for i in range(0, len(address), 11):
-            blockStr: str = address[i : i + 11]
-            blockInt: int = 0
-
-            multi = 1
-            for char in blockStr[::-1]:
-                blockInt += multi * BASE58.index(char)
-                multi = multi * 58
-
-            if len(blockStr) == 11:
-                data += blockInt.to_bytes(8, byteorder="big")
-            elif len(blockStr) == 7:
-                data += blockInt.to_bytes(5, byteorder="big")
-
-        # Extract the payment ID and checksum.
-        payment_id: Optional[bytes]
-        if crypto.payment_id_leading:
-            payment_id = data[crypto.network_byte_length : -68]
-        else:
-            payment_id = data[(crypto.network_byte_length + 64) : -4]
+        # Payment ID.
+        payment_id: Optional[bytes] = payment_id_bytes
         if not payment_id:
             payment_id = None
-        checksum: bytes = data[-4:]
-
-        # Check the checksum.
-        checksum_hash: Any = keccak.new(digest_bits=256)
-        checksum_hash.update(data[0:-4])
-        if checksum_hash.digest()[0:4] != checksum:
-            raise AddressError("Invalid address checksum.")
+        elif len(payment_id) not in crypto.payment_id_lengths:
+            raise AddressError("Invalid address.")
 
         # Verify the network byte is valid.
-        network_byte: bytes = data[0 : crypto.network_byte_length]
         if (network_byte not in crypto.network_bytes) or (
             (payment_id is not None) and (network_byte != crypto.network_bytes[1])
         ):
             raise AddressError("Address doesn't have a valid network byte.")
 
         # Return the Address.
-        view_key: bytes
-        spend_key: bytes
-        if crypto.payment_id_leading:
-            view_key = data[-36:-4]
-            spend_key = data[-68:-36]
-        else:
-            view_key = data[
-                (crypto.network_byte_length + 32) : (crypto.network_byte_length + 64)
-            ]
-            spend_key = data[
-                crypto.network_byte_length : (crypto.network_byte_length + 32)
-            ]
         return Address(
             crypto,
             (view_key, spend_key),
             payment_id,
             network_byte,
             address,
+            True,
         )
 
+    @staticmethod
+    def parse(crypto: Crypto, address: str) -> Any:
+        """
+        Parse an address and extract the contained info.
+        Raises AddressError if it fails to parse the address.
+        """
+
+        return Address.from_decoded(
+            crypto,
+            address,
+            decode_addresses_many(
+                [address], crypto.network_byte_length, crypto.payment_id_leading, 1
+            )[0],
+        )
+
+    @staticmethod
+    def parse_many(crypto: Crypto, addresses: List[str]) -> List[Optional[Any]]:
+        """
+        Parse many addresses at once, decoding them natively over every core.
+        Addresses which fail to parse are None.
+        """
+
+        result: List[Optional[Address]] = []
+        for address, decoded in zip(
+            addresses,
+            decode_addresses_many(
+                addresses, crypto.network_byte_length, crypto.payment_id_leading
+            ),
+        ):
+            try:
+                result.append(Address.from_decoded(crypto, address, decoded))
+            except AddressError:
+                result.append(None)
+        return result
+
     def __eq__(self, other: Any) -> bool:
         """Equality operator. Used by the tests."""
 
@@ -0,0 +1,187 @@
+"""Balances file. Keeps totals per subaddress and account as outputs change state."""
+
+# Types.
+from typing import Dict, List, Set, Tuple, Mapping, Optional
+
+# heapq standard lib.
+from heapq import heapify, heappush, heappop
+
+# OutputIndex class.
+from cryptonote.classes.blockchain import OutputIndex
+
+# Crypto classes.
+from cryptonote.crypto.crypto import InputState, OutputInfo
+from cryptonote.crypto.monero_crypto import MoneroOutputInfo
+
+# Positions of each kind of amount in a Balance.
+UNLOCKED: int = 0
+LOCKED: int = 1
+PENDING: int = 2
+
+
+class Balance:
+    """
+    Balance class.
+    Amounts which are usable, still locked, and reserved by unfinalized sends.
+    """
+
+    def __init__(self, unlocked: int = 0, locked: int = 0, pending: int = 0) -> None:
+        """Constructor."""
+
+        self.amounts: List[int] = [unlocked, locked, pending]
+
+    @property
+    def unlocked(self) -> int:
+        return self.amounts[UNLOCKED]
+
+    @property
+    def locked(self) -> int:
+        return self.amounts[LOCKED]
+
+    @property
+    def pending(self) -> int:
+        return self.amounts[PENDING]
+
+    def copy(self) -> "Balance":
+        """Copy a Balance so it isn't changed by future updates."""
+
+        return Balance(*self.amounts)
+
+    def __eq__(self, other: object) -> bool:
+        return isinstance(other, Balance) and (self.amounts == other.amounts)
+
+    def __repr__(self) -> str:
+        return "Balance(unlocked={}, locked={}, pending={})".format(*self.amounts)
+
+
+class Balances:
+    """
+    Balances class.
+    Totals of the outputs, per subaddress and per account, updated as they change state.
+    Locked outputs are queued by their timelock and moved once it passes.
+    Every state change must go through set_state for the totals to stay correct.
+    """
+
+    def __init__(self, outputs: Mapping[OutputIndex, OutputInfo]) -> None:
+        """Constructor. Outputs are looked up in outputs when they unlock."""
+
+        self.outputs: Mapping[OutputIndex, OutputInfo] = outputs
+
+        # Height outputs are usable at if their timelock is less than it.
+        self.height: int = 0
+
+        self.total: Balance = Balance()
+        self.subaddresses: Dict[Tuple[int, int], Balance] = {}
+        self.accounts: Dict[int, Balance] = {}
+
+        # Min-heap of unlock heights, along with the outputs which unlock at them.
+        self.unlocks: List[Tuple[int, bytes, int]] = []
+        self.queued: Set[OutputIndex] = set()
+
+    @staticmethod
+    def subaddress(output: OutputInfo) -> Tuple[int, int]:
+        """Get the subaddress an output was received to."""
+
+        if isinstance(output, MoneroOutputInfo):
+            return output.subaddress
+        return (0, 0)
+
+    def kind(self, output: OutputInfo, state: InputState) -> Optional[int]:
+        """Get which amount an output counts towards in the specified state."""
+
+        if state == InputState.Spendable:
+            return LOCKED if output.timelock >= self.height else UNLOCKED
+        if state == InputState.Transmitted:
+            return PENDING
+        return None
+
+    def move(self, output: OutputInfo, old: Optional[int], new: Optional[int]) -> None:
+        """Move an output's amount between the specified kinds of amount."""
+
+        if old == new:
+            return
+
+        subaddress: Tuple[int, int] = Balances.subaddress(output)
+        if subaddress not in self.subaddresses:
+            self.subaddresses[subaddress] = Balance()
+            if subaddress[0] not in self.accounts:
+                self.accounts[subaddress[0]] = Balance()
+
+        amount: int = output.amount
+        for balance in [
+            self.total,
+            self.subaddresses[subaddress],
+            self.accounts[subaddress[0]],
+        ]:
+            if old is not None:
+                balance.amounts[old] -= amount
+            if new is not None:
+                balance.amounts[new] += amount
+
+        if (new == LOCKED) and (output.index not in self.queued):
+            self.queued.add(output.index)
+            heappush(
+                self.unlocks,
+                (output.timelock, output.index.tx_hash, output.index.index),
+            )
+
+    def add(self, output: OutputInfo) -> None:
+        """Count a newly found output."""
+
+        self.move(output, None, self.kind(output, output.state))
+
+    def set_state(self, output: OutputInfo, state: InputState) -> None:
+        """Update an output's state."""
+
+        self.move(output, self.kind(output, output.state), self.kind(output, state))
+        output.state = state
+
+    def advance(self, height: int) -> None:
+        """Advance to a height, unlocking every output whose timelock passed."""
+
+        self.height = max(self.height, height)
+        while self.unlocks and (self.unlocks[0][0] < self.height):
+            index: OutputIndex = OutputIndex(*heappop(self.unlocks)[1:])
+            self.queued.discard(index)
+
+            # Outputs which were reserved or spent while locked were already moved.
+            output: OutputInfo = self.outputs[index]
+            if output.state == InputState.Spendable:
+                self.move(output, LOCKED, UNLOCKED)
+
+    def load(
+        self,
+        height: int,
+        totals: Dict[Tuple[int, int], Tuple[int, int, int]],
+        locked: List[Tuple[int, bytes, int]],
+    ) -> None:
+        """
+        Replace every total with ones calculated in bulk at the specified height.
+        locked is the timelock, hash, and index of every output still locked.
+        """
+
+        self.height = height
+        self.total = Balance()
+        self.subaddresses = {}
+        self.accounts = {}
+        for subaddress in totals:
+            self.subaddresses[subaddress] = Balance(*totals[subaddress])
+            if subaddress[0] not in self.accounts:
+                self.accounts[subaddress[0]] = Balance()
+            for balance in [self.total, self.accounts[subaddress[0]]]:
+                for kind in range(3):
+                    balance.amounts[kind] += totals[subaddress][kind]
+
+        self.unlocks = list(locked)
+        heapify(self.unlocks)
+        self.queued = {OutputIndex(unlock[1], unlock[2]) for unlock in locked}
+
+    def subaddress_balance(self, subaddress: Tuple[int, int]) -> Balance:
+        """Get the Balance of a subaddress."""
+
+        return self.subaddresses.get(subaddress, Balance()).copy()
+
+    def account_balance(self, account: int) -> Balance:
+        """Get the Balance of an account."""
+
+        return self.accounts.get(account, Balance()).copy()
@@ -0,0 +1,207 @@
+"""Input index file. Keeps outputs sorted by amount in order to quickly select inputs."""
+
+# Types.
+from typing import Dict, List, Set, Tuple, Iterable, Mapping, Callable, Optional
+
+# heapq standard lib.
+from heapq import heappush, heappop, heapify
+
+# OutputIndex class.
+from cryptonote.classes.blockchain import OutputIndex
+
+# Crypto classes.
+from cryptonote.crypto.crypto import InputState, OutputInfo
+
+# Native sorted keys.
+from cryptonote.lib.monero_rct.c_monero_rct import InputKeys
+
+# Sort key of an output. Amount, unlock height, and then its index as a tie breaker.
+IndexKey = Tuple[int, int, bytes, int]
+
+
+class InputIndex:
+    """
+    InputIndex class.
+    Spendable outputs, sorted by amount and unlock height in a native tree.
+    Only usable outputs are in the tree, so selection never steps over others.
+    Locked outputs are queued by timelock until selection's height passes it.
+    Owners call update whenever an output's state changes.
+    """
+
+    def __init__(
+        self,
+        outputs: Iterable[OutputInfo] = (),
+        store: Optional[Mapping[OutputIndex, OutputInfo]] = None,
+    ) -> None:
+        """
+        Constructor.
+        If a store is passed, outputs are looked up in it and only their keys are kept.
+        The store's owner is then responsible for adding outputs to it.
+        """
+
+        self.tree: InputKeys = InputKeys()
+        self.height: int = 0
+        # Keys of locked outputs, by timelock, and the set of those still indexed.
+        self.unlocks: List[Tuple[int, IndexKey]] = []
+        self.queued: Set[IndexKey] = set()
+
+        owned: Dict[OutputIndex, OutputInfo] = {}
+        self.owned: Optional[Dict[OutputIndex, OutputInfo]] = (
+            owned if store is None else None
+        )
+        self.outputs: Mapping[OutputIndex, OutputInfo] = (
+            owned if store is None else store
+        )
+        for output in outputs:
+            self.add(output)
+
+    @staticmethod
+    def key(output: OutputInfo) -> IndexKey:
+        """Get the sort key of an output."""
+
+        return (
+            output.amount,
+            output.timelock,
+            output.index.tx_hash,
+            output.index.index,
+        )
+
+    def __len__(self) -> int:
+        return len(self.tree) + len(self.queued)
+
+    def keys(self) -> List[IndexKey]:
+        """Get the keys of every indexed output, sorted."""
+
+        return sorted(self.tree.list() + list(self.queued))
+
+    def load(self, keys: List[IndexKey], height: int) -> None:
+        """
+        Replace the index with the already sorted keys of every Spendable output.
+        Outputs with a timelock at or after height are queued until it passes.
+        """
+
+        self.height = height
+        self.tree.load([key for key in keys if key[1] < height])
+        self.queued = {key for key in keys if key[1] >= height}
+        self.unlocks = [(key[1], key) for key in self.queued]
+        heapify(self.unlocks)
+
+    def add(self, output: OutputInfo) -> None:
+        """Add an output. Indexed and non-Spendable outputs are ignored."""
+
+        if output.state != InputState.Spendable:
+            return
+        if self.owned is not None:
+            self.owned[output.index] = output
+        elif output.index not in self.outputs:
+            return
+
+        key: IndexKey = InputIndex.key(output)
+        if key[1] < self.height:
+            self.tree.add(key)
+        elif key not in self.queued:
+            self.queued.add(key)
+            heappush(self.unlocks, (key[1], key))
+
+    def discard(self, output: OutputInfo) -> None:
+        """Remove an output if it's indexed."""
+
+        key: IndexKey = InputIndex.key(output)
+        self.tree.remove(key)
+        self.queued.discard(key)
+        if self.owned is not None:
+            self.owned.pop(output.index, None)
+
+    def remove(self, index: OutputIndex) -> None:
+        """Remove an output."""
+
+        if index in self.outputs:
+            self.discard(self.outputs[index])
+
+    def update(self, output: OutputInfo) -> None:
+        """Add or remove an output after its state changed."""
+
+        if output.state == InputState.Spendable:
+            self.add(output)
+        else:
+            self.discard(output)
+
+    def advance(self, height: int) -> None:
+        """Advance to a height, moving outputs whose timelock passed into the tree."""
+
+        self.height = max(self.height, height)
+        while self.unlocks and (self.unlocks[0][0] < self.height):
+            key: IndexKey = heappop(self.unlocks)[1]
+
+            # Outputs which were reserved or spent while locked were already removed.
+            if key in self.queued:
+                self.queued.remove(key)
+                self.tree.add(key)
+
+    def output(self, key: IndexKey) -> OutputInfo:
+        """Get the output with the specified key."""
+
+        return self.outputs[OutputIndex(key[2], key[3])]
+
+    def best_fit(
+        self, value: int, height: int, excluded: Optional[List[OutputInfo]] = None
+    ) -> Optional[OutputInfo]:
+        """
+        Get the smallest usable output with an amount of at least value.
+        Outputs in excluded are skipped.
+        """
+
+        self.advance(height)
+        key: Optional[IndexKey] = self.tree.ceiling(
+            value,
+            height,
+            [] if excluded is None else [InputIndex.key(output) for output in excluded],
+        )
+        if key is None:
+            return None
+        return self.output(key)
+
+    def below(self, value: int, height: int) -> List[OutputInfo]:
+        """Get every usable output with an amount less than value, largest first."""
+
+        self.advance(height)
+        return [self.output(key) for key in self.tree.below(value, height)]
+
+    def select(
+        self, required: Callable[[int], int], height: int, minimum_input: int = 0
+    ) -> List[OutputInfo]:
+        """
+        Select inputs to cover the amount returned by required, which is passed the amount of inputs.
+        Prefers the single smallest output which covers the amount.
+        Else, uses the fewest inputs which can cover the amount, minimizing the weight.
+        Which ones is chosen by a bounded branch and bound, for the least excess.
+        Outputs with an amount less than minimum_input are never selected.
+
+        Returns an empty List if the usable outputs can't cover the amount.
+        """
+
+        # Best fit single input.
+        single: Optional[OutputInfo] = self.best_fit(
+            max(required(1), minimum_input), height
+        )
+        if single is not None:
+            return [single]
+
+        # The largest outputs cover the amount with the fewest inputs.
+        # They're fetched in growing batches, as the amount needed depends on the count.
+        largest: List[IndexKey] = []
+        total: int = 0
+        count: int = 0
+        while (count == 0) or (total < required(count)):
+            if count == len(largest):
+                largest = self.tree.largest(max(2 * count, 16), minimum_input, height)
+                if count == len(largest):
+                    return []
+            total += largest[count][0]
+            count += 1
+
+        # Choose that many outputs with the least excess.
+        return [
+            self.output(key)
+            for key in self.tree.fit(count, required(count), minimum_input, height)
+        ]
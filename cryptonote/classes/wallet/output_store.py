@@ -0,0 +1,147 @@
+"""Output store file. Keeps a wallet's outputs as compact native records."""
+
+# Types.
+from typing import Mapping, Iterator, Tuple, Any
+
+# Native output store.
+from cryptonote.lib.monero_rct.c_monero_rct import OutputStore, WalletDB
+
+# OutputIndex class.
+from cryptonote.classes.blockchain import OutputIndex
+
+# Crypto classes.
+from cryptonote.crypto.crypto import InputState, OutputInfo
+from cryptonote.crypto.monero_crypto import MoneroOutputInfo
+
+# Fields stored for OutputInfos which don't have Monero's.
+NO_SUBADDRESS: Tuple[int, int] = (0, 0)
+NO_KEY: bytes = bytes(32)
+
+
+class StoredOutputInfo(OutputInfo):
+    """
+    StoredOutputInfo class.
+    Lazy view of an output in an OutputStore.
+    Fields are read from the store on access and changes to the state are written back.
+    Signing data (mixins, ring, and image) is only set on the view being signed with.
+    It isn't stored, so a view from another lookup won't have it.
+    """
+
+    def __init__(self, store: OutputStore, record: int) -> None:
+        """Constructor. Every field is read from the store."""
+
+        self.store: OutputStore = store
+        self.record: int = record
+
+    @property  # type: ignore
+    def index(self) -> OutputIndex:
+        return OutputIndex(
+            self.store.tx_hash(self.record), self.store.index(self.record)
+        )
+
+    @property  # type: ignore
+    def timelock(self) -> int:
+        return self.store.timelock(self.record)
+
+    @property  # type: ignore
+    def amount(self) -> int:
+        return self.store.amount(self.record)
+
+    @property  # type: ignore
+    def spend_key(self) -> bytes:
+        return self.store.spend_key(self.record)
+
+    @property  # type: ignore
+    def state(self) -> InputState:
+        return InputState(self.store.state(self.record))
+
+    @state.setter
+    def state(self, state: InputState) -> None:
+        self.store.set_state(self.record, state.value)
+
+
+class StoredMoneroOutputInfo(StoredOutputInfo, MoneroOutputInfo):
+    """StoredOutputInfo which also reads MoneroOutputInfo's fields from the store."""
+
+    @property  # type: ignore
+    def subaddress(self) -> Tuple[int, int]:
+        return self.store.subaddress(self.record)
+
+    @property  # type: ignore
+    def amount_key(self) -> bytes:
+        return self.store.amount_key(self.record)
+
+    @property  # type: ignore
+    def commitment(self) -> bytes:
+        return self.store.commitment(self.record)
+
+
+class StoredOutputs(Mapping[OutputIndex, OutputInfo]):
+    """
+    StoredOutputs class.
+    Outputs indexed by their OutputIndex, stored natively as fixed-width records.
+    Lookups are O(1) and return lazy views, so no Python objects are kept per output.
+    Outputs can be added, yet not replaced or removed.
+    Outputs which were MoneroOutputInfos are viewed as them.
+    """
+
+    def __init__(self) -> None:
+        """Constructor."""
+
+        self.store: OutputStore = OutputStore()
+
+    def load(self, db: WalletDB) -> int:
+        """Load every output in a WalletDB, which then tracks changes to them."""
+
+        return db.load(self.store)
+
+    def __getitem__(self, index: OutputIndex) -> OutputInfo:
+        record: int = self.store.find(index.tx_hash, index.index)
+        if record == -1:
+            raise KeyError(index)
+        if self.store.monero(record):
+            return StoredMoneroOutputInfo(self.store, record)
+        return StoredOutputInfo(self.store, record)
+
+    def __contains__(self, index: Any) -> bool:
+        return self.store.find(index.tx_hash, index.index) != -1
+
+    def __setitem__(self, index: OutputIndex, output: OutputInfo) -> None:
+        """
+        Store an output.
+        OutputInfos without Monero's fields are stored with them zeroed.
+        They're viewed as plain OutputInfos.
+        """
+
+        if index in self:
+            raise Exception("Output is already stored.")
+
+        subaddress: Tuple[int, int] = NO_SUBADDRESS
+        amount_key: bytes = NO_KEY
+        commitment: bytes = NO_KEY
+        monero: bool = False
+        if isinstance(output, MoneroOutputInfo):
+            subaddress = output.subaddress
+            amount_key = output.amount_key
+            commitment = output.commitment
+            monero = True
+
+        self.store.add(
+            index.tx_hash,
+            index.index,
+            output.timelock,
+            output.amount,
+            output.spend_key,
+            subaddress,
+            amount_key,
+            commitment,
+            output.state.value,
+            monero,
+        )
+
+    def __iter__(self) -> Iterator[OutputIndex]:
+        for record in range(len(self.store)):
+            yield OutputIndex(self.store.tx_hash(record), self.store.index(record))
+
+    def __len__(self) -> int:
+        return len(self.store)
@@ -9,6 +9,12 @@ from collections import deque
 # urandom standard function.
 from os import urandom
 
+# monotonic standard function.
+from time import monotonic
+
+# Lock standard class.
+from threading import Lock
+
 # Ed25519 lib.
 import cryptonote.lib.ed25519 as ed
 
@@ -18,12 +24,26 @@ from cryptonote.classes.wallet.address import Address
 # Blockchain classes.
 from cryptonote.classes.blockchain import OutputIndex, Transaction, Block
 
+# InputIndex class.
+from cryptonote.classes.wallet.input_index import InputIndex
+
+# StoredOutputs class.
+from cryptonote.classes.wallet.output_store import StoredOutputs
+
+# Balance classes.
+from cryptonote.classes.wallet.balances import Balance, Balances
+
+# Native wallet database.
+from cryptonote.lib.monero_rct.c_monero_rct import WalletDB
+
 # Crypto class.
 from cryptonote.crypto.crypto import (
     InputState,
     OutputInfo,
     SpendableOutput,
     SpendableTransaction,
+    SigningContext,
+    ScannedTransaction,
     Crypto,
 )
 
@@ -46,6 +66,22 @@ class FeeError(Exception):
     """FeeError Exception. Used when the fee is too low."""
 
 
+# Maximum amount of destinations in a Transaction.
+# Monero allows 16 outputs, and one is reserved for change.
+MAX_DESTINATIONS: int = 15
+
+# Seconds inputs stay reserved for a prepared send which is never finalized.
+RESERVATION_TIMEOUT: float = 60 * 60
+
+# Blocks rescanned when a database's last scanned Block was reorganized out.
+# Only that Block's hash is stored, so the fork point can't be found exactly.
+REORG_RESCAN_DEPTH: int = 100
+
+# Maximum amount of inputs in a sweep Transaction.
+# Keeps its weight well under the limit nodes relay.
+MAX_SWEEP_INPUTS: int = 120
+
+
 class WatchWallet:
     """
     WatchWallet class.
@@ -61,16 +97,31 @@ class WatchWallet:
                 self.rpc.get_block(self.rpc.get_block_hash(b))
             )
         self.last_block = max(self.last_block, height - 1)
+        with self.reservation_lock:
+            self.balances.advance(height)
 
         result: Dict[OutputIndex, OutputInfo] = {}
         while len(self.confirmation_queue) > self.crypto.confirmations:
             usable: Block = self.confirmation_queue.popleft()
-            for tx in usable.hashes + [usable.header.miner_tx_hash]:
+            txs: List[Transaction] = [
+                self.rpc.get_transaction(tx)
+                for tx in usable.hashes + [usable.header.miner_tx_hash]
+            ]
+
+            # Scan the whole Block at once so the derivations can be batched.
+            scanned: List[ScannedTransaction] = self.crypto.scan_transactions(
+                self.private_view_key, txs, self.variable_time_scanning
+            )
+            for t in range(len(txs)):
                 new_inputs: Dict[OutputIndex, OutputInfo] = self.can_spend(
-                    self.rpc.get_transaction(tx)
+                    txs[t], scanned[t]
                 )[1]
                 for index in new_inputs:
                     result[index] = new_inputs[index]
+
+            # Commit the Block's outputs along with it as the last scanned Block.
+            with self.reservation_lock:
+                self.persist((usable.header.height, usable.header.hash))
         return dict(result)
 
     def load_state(
@@ -80,7 +131,12 @@ class WatchWallet:
         """Load the state."""
 
         self.last_block: int
-        if isinstance(state, int):
+        checkpoint: Optional[Tuple[int, bytes]] = (
+            None if self.db is None else self.db.checkpoint()
+        )
+        if (self.db is not None) and (checkpoint is not None):
+            self.load_db(self.db, checkpoint)
+        elif isinstance(state, int):
             self.last_block = state
         else:
             self.last_block = state["last_block"] - 10
@@ -88,18 +144,68 @@ class WatchWallet:
             for json_output in state["inputs"]:
                 output: OutputInfo = self.crypto.output_from_json(json_output)
                 self.inputs[output.index] = output
+                self.input_index.add(output)
+                self.balances.add(output)
 
             for unique_factor in state["unique_factors"]:
-                self.unique_factors[bytes.fromhex(unique_factor)] = (
-                    state["unique_factors"][unique_factor][0],
-                    state["unique_factors"][unique_factor][1],
+                self.watch_unique_factor(
+                    bytes.fromhex(unique_factor),
+                    (
+                        state["unique_factors"][unique_factor][0],
+                        state["unique_factors"][unique_factor][1],
+                    ),
                 )
 
+        # Outputs stay locked until the next poll confirms the height.
+        self.balances.advance(self.last_block + 1)
+
+        # Write the loaded state, so the database has it before a Block is scanned.
+        with self.reservation_lock:
+            self.persist()
+
         # Poll blocks to rebuild the cache.
         # -1 is a value used in the unit tests in order to not make any RPC calls.
         if self.last_block != -1:
             self.poll_blocks()
 
+    def load_db(self, db: WalletDB, checkpoint: Tuple[int, bytes]) -> None:
+        """
+        Load the state from the database, resuming after its last scanned Block.
+        If that Block was reorganized out, the Blocks before it are rescanned.
+        Outputs found in orphaned Blocks are kept, as outputs are never removed.
+        Outputs are copied natively out of the memory map.
+        The index and balances are then built in bulk.
+        """
+
+        self.last_block = checkpoint[0]
+        if self.rpc.get_block_hash(checkpoint[0]) != checkpoint[1]:
+            self.last_block = max(checkpoint[0] - REORG_RESCAN_DEPTH, 0)
+
+        self.inputs.load(db)
+        self.input_index.load(self.inputs.store.index_keys(), self.last_block + 1)
+        self.balances.load(
+            self.last_block + 1, *self.inputs.store.totals(self.last_block + 1)
+        )
+
+        for spend_key, major, minor in db.subaddresses():
+            self.unique_factors[spend_key] = (major, minor)
+
+    def persist(self, checkpoint: Optional[Tuple[int, bytes]] = None) -> None:
+        """
+        Write every change since the last call to the database, if there is one, in one transaction.
+        Reservations aren't written, so reserving and releasing inputs doesn't need a commit.
+        checkpoint is the height and hash of the last scanned Block, if one was just scanned.
+        Must be called with the reservation lock held.
+        """
+
+        if self.db is None:
+            return
+        self.db.commit(
+            self.inputs.store, self.new_unique_factors, self.new_key_images, checkpoint
+        )
+        self.new_unique_factors = []
+        self.new_key_images = []
+
     def __init__(
         self,
         crypto: Crypto,
@@ -107,8 +213,17 @@ class WatchWallet:
         private_view_key: bytes,
         public_spend_key: bytes,
         state: Union[int, Dict[str, Any]],
+        variable_time_scanning: bool = False,
+        db_path: Optional[str] = None,
     ) -> None:
-        """Constructor."""
+        """
+        Constructor.
+        variable_time_scanning derives shared keys faster, yet with timing dependent on the private view key.
+        Only enable it on hosts where that timing can't be observed.
+
+        db_path is an LMDB file the state is persisted to as it changes, with a commit per scanned Block.
+        If it has a scanned Block, the state is loaded from it and the passed in state is ignored.
+        """
 
         # Set the Crypto class.
         self.crypto: Crypto = crypto
@@ -116,6 +231,9 @@ class WatchWallet:
         # Set the RPC class.
         self.rpc: RPC = rpc
 
+        # Whether scanning may take time dependent on the private view key.
+        self.variable_time_scanning: bool = variable_time_scanning
+
         # Set the spend key.
         self.public_spend_key: bytes = public_spend_key
 
@@ -125,14 +243,32 @@ class WatchWallet:
 
         # Blocks whose Transactions have yet to confirm.
         self.confirmation_queue: Deque[Block] = deque([])
-        # Inputs.
-        self.inputs: Dict[OutputIndex, OutputInfo] = {}
+        # Inputs, stored natively.
+        self.inputs: StoredOutputs = StoredOutputs()
+        # Spendable inputs sorted by amount, used for selection.
+        self.input_index: InputIndex = InputIndex(store=self.inputs)
+        # Totals of the inputs, per subaddress and account.
+        self.balances: Balances = Balances(self.inputs)
+
+        # Reservations of inputs by prepared sends.
+        # Each input maps to its reservation's ID, expiry, and OutputInfo.
+        # Guarded by the lock, along with input states, the index, and the balances.
+        self.reservation_lock: Lock = Lock()
+        self.reservations: Dict[OutputIndex, Tuple[int, float, OutputInfo]] = {}
+        self.next_reservation: int = 0
+        self.reservation_timeout: float = RESERVATION_TIMEOUT
 
         # Unique factors.
         self.unique_factors: Dict[bytes, Tuple[int, int]] = {
             self.public_spend_key: (0, 0)
         }
 
+        # Database the state is persisted to, and the changes yet to be written to it.
+        # The changes are guarded by the reservation lock.
+        self.db: Optional[WalletDB] = None if db_path is None else WalletDB(db_path)
+        self.new_unique_factors: List[Tuple[bytes, int, int]] = []
+        self.new_key_images: List[Tuple[bytes, bytes, int]] = []
+
         # Reload the state.
         self.load_state(state)
 
@@ -156,6 +292,18 @@ class WatchWallet:
 
         return result
 
+    def watch_unique_factor(self, unique_factor: bytes, index: Tuple[int, int]) -> None:
+        """
+        Watch for a unique factor, queueing it to be written to the database.
+        Must be called without the reservation lock held.
+        """
+
+        with self.reservation_lock:
+            if unique_factor not in self.unique_factors:
+                self.unique_factors[unique_factor] = index
+                if self.db is not None:
+                    self.new_unique_factors.append((unique_factor, index[0], index[1]))
+
     def regenerate_unique_factors(self, index: Tuple[int, int]) -> None:
         """Regenerates the unique factors for X from 0 .. Y."""
 
@@ -166,8 +314,10 @@ class WatchWallet:
                 (self.public_view_key, self.public_spend_key), (index[0], addr)
             )
 
-            if properties[0][1] not in self.unique_factors:
-                self.unique_factors[properties[0][1]] = (index[0], addr)
+            self.watch_unique_factor(properties[0][1], (index[0], addr))
+
+        with self.reservation_lock:
+            self.persist()
 
     def new_address(self, unique_factor: Union[Tuple[int, int], bytes]) -> Address:
         """Creates a new address."""
@@ -178,17 +328,70 @@ class WatchWallet:
             (self.private_view_key, self.public_spend_key), unique_factor
         )
 
-        if properties[0][1] not in self.unique_factors:
-            if not isinstance(unique_factor, bytes):
-                self.unique_factors[properties[0][1]] = unique_factor
+        if not isinstance(unique_factor, bytes):
+            self.watch_unique_factor(properties[0][1], unique_factor)
+            with self.reservation_lock:
+                self.persist()
 
         return Address(
             self.crypto, properties[0], properties[1], network_byte=properties[2]
         )
 
+    def new_addresses(self, major: int, start: int, count: int) -> List[Address]:
+        """
+        Creates the subaddresses (major, start) to (major, start + count - 1).
+        Watches for all of them, just as new_address does, from the same pass.
+        """
+
+        subaddresses: List[
+            Tuple[Tuple[bytes, bytes], bytes, str]
+        ] = self.crypto.new_addresses(
+            (self.private_view_key, self.public_spend_key), major, start, count
+        )
+
+        # Watch every spend key under one acquisition of the lock.
+        with self.reservation_lock:
+            new: Dict[bytes, Tuple[int, int]] = {
+                subaddress[0][1]: (major, start + i)
+                for i, subaddress in enumerate(subaddresses)
+                if subaddress[0][1] not in self.unique_factors
+            }
+            self.unique_factors.update(new)
+            if self.db is not None:
+                self.new_unique_factors.extend(
+                    (spend_key, index[0], index[1]) for spend_key, index in new.items()
+                )
+            self.persist()
+
+        # The addresses were encoded natively, so they're built as decoded ones.
+        return [
+            Address.from_decoded(
+                self.crypto, address, (network_byte, key_pair[1], key_pair[0], b"")
+            )
+            for key_pair, network_byte, address in subaddresses
+        ]
+
+    def balance(self, subaddress: Optional[Tuple[int, int]] = None) -> Balance:
+        """
+        Get the Balance of a subaddress, or of the whole wallet if none is specified.
+        Outputs are considered unlocked as of the height of the last poll.
+        """
+
+        with self.reservation_lock:
+            if subaddress is None:
+                return self.balances.total.copy()
+            return self.balances.subaddress_balance(subaddress)
+
+    def account_balance(self, account: int) -> Balance:
+        """Get the Balance of an account, every subaddress with its major index."""
+
+        with self.reservation_lock:
+            return self.balances.account_balance(account)
+
     def can_spend(
         self,
         tx: Transaction,
+        scanned: Optional[ScannedTransaction] = None,
     ) -> Tuple[List[bytes], Dict[OutputIndex, OutputInfo]]:
         """
         Returns the found payment IDs and spendable outputs (OutputInfos indexed by OutputIndexes).
@@ -198,12 +401,16 @@ class WatchWallet:
         Any amount other than one causes the deposit destination to not be determinable.
 
         On subaddress networks, the unique factor is the spend key contained in the OutputInfo.
+
+        scanned is the Transaction's result from Crypto.scan_transactions, if it was already scanned.
         """
 
         # Create the shared keys.
-        shared_keys: List[bytes] = []
-        for R in tx.Rs:
-            shared_keys.append(self.crypto.create_shared_key(self.private_view_key, R))
+        if scanned is None:
+            scanned = self.crypto.scan_transactions(
+                self.private_view_key, [tx], self.variable_time_scanning
+            )[0]
+        shared_keys: List[bytes] = scanned[0]
 
         # Get the payment IDs.
         payment_IDs: List[bytes] = self.crypto.get_payment_IDs(
@@ -216,7 +423,7 @@ class WatchWallet:
         # Result.
         result: Dict[OutputIndex, OutputInfo] = {}
 
-        for shared_key in shared_keys:
+        for s, shared_key in enumerate(shared_keys):
             # Check each output unless it's already been found spendable.
             # Quality optimization due to how slow Python ed25519 is.
             # Also necessary to stop exploits based on R reuse (handled elsewhere) and torsion points (not handled elsewhere).
@@ -225,30 +432,132 @@ class WatchWallet:
                     continue
 
                 can_spend_res: Optional[OutputInfo] = self.crypto.can_spend_output(
-                    self.unique_factors, shared_key, tx, o
+                    self.unique_factors,
+                    shared_key,
+                    tx,
+                    o,
+                    None if scanned[1] is None else scanned[1][s][o],
                 )
                 if can_spend_res is not None:
                     spendable_outputs.add(o)
                     result[OutputIndex(tx.tx_hash, o)] = can_spend_res
 
         # Merge the new TXOs into the Wallet's TXOs.
-        for txo in result:
-            if txo in self.inputs:
-                continue
+        with self.reservation_lock:
+            for txo in result:
+                if txo in self.inputs:
+                    continue
 
-            self.inputs[txo] = result[txo]
+                self.inputs[txo] = result[txo]
+                self.input_index.add(result[txo])
+                self.balances.add(result[txo])
 
         # Return the payment IDs + result.
         return (payment_IDs, result)
 
     def rebuild_input_states(self, key_images: List[Dict[str, Any]]) -> None:
-        """Marks spent inputs as spent."""
+        """
+        Marks spent inputs as spent. Every key image is recorded in the database.
+        The results are written in one commit once every image is checked.
+        """
 
         for image in key_images:
-            if self.rpc.is_key_image_spent(bytes.fromhex(image["image"])):
-                self.inputs[
-                    OutputIndex(bytes.fromhex(image["hash"]), image["index"])
-                ].state = InputState.Spent
+            index: OutputIndex = OutputIndex(
+                bytes.fromhex(image["hash"]), image["index"]
+            )
+            spent: bool = self.rpc.is_key_image_spent(bytes.fromhex(image["image"]))
+            with self.reservation_lock:
+                if self.db is not None:
+                    self.new_key_images.append(
+                        (bytes.fromhex(image["image"]), index.tx_hash, index.index)
+                    )
+                if spent:
+                    self.set_state(self.inputs[index], InputState.Spent)
+                    self.reservations.pop(index, None)
+
+        with self.reservation_lock:
+            self.persist()
+
+    def set_state(self, output: OutputInfo, state: InputState) -> None:
+        """
+        Update an output's state, moving it between balances and in or out of the index.
+        Must be called with the reservation lock held.
+        """
+
+        self.balances.set_state(output, state)
+        self.input_index.update(output)
+
+    def reserve(self, selected: List[OutputInfo]) -> int:
+        """
+        Reserves the selected inputs, updating their state to Transmitted.
+        Returns the reservation's ID.
+        Must be called with the reservation lock held.
+        """
+
+        reservation: int = self.next_reservation
+        self.next_reservation += 1
+        expiry: float = monotonic() + self.reservation_timeout
+        for output in selected:
+            self.set_state(output, InputState.Transmitted)
+            self.reservations[output.index] = (reservation, expiry, output)
+        return reservation
+
+    def expire_reservations(self) -> None:
+        """
+        Makes inputs whose reservations expired Spendable again.
+        Must be called with the reservation lock held.
+        """
+
+        now: float = monotonic()
+        for index in [
+            index
+            for index in self.reservations
+            if self.reservations[index][1] <= now
+        ]:
+            if self.reservations[index][2].state == InputState.Transmitted:
+                self.set_state(self.reservations[index][2], InputState.Spendable)
+            del self.reservations[index]
+
+    @staticmethod
+    def context_inputs(context: Dict[str, Any]) -> List[OutputIndex]:
+        """Get the indexes of a context's inputs."""
+
+        return [
+            OutputIndex(bytes.fromhex(input_i["hash"]), input_i["index"])
+            for input_i in context["inputs"]
+        ]
+
+    def settle(
+        self, indexes: List[OutputIndex], reservation: Optional[int], spent: bool
+    ) -> None:
+        """
+        Updates the state of reserved inputs, ending their reservation.
+        If the inputs weren't spent, they're only made Spendable while still under this reservation.
+        This stops an expired send from releasing inputs another send has since reserved.
+        """
+
+        with self.reservation_lock:
+            for index in indexes:
+                reserved: Optional[
+                    Tuple[int, float, OutputInfo]
+                ] = self.reservations.get(index)
+                owned: bool = (reservation is None) or (
+                    (reserved is not None) and (reserved[0] == reservation)
+                )
+                output: OutputInfo = (
+                    self.inputs[index] if reserved is None else reserved[2]
+                )
+
+                if spent:
+                    self.set_state(output, InputState.Spent)
+                    self.reservations.pop(index, None)
+                elif owned:
+                    self.set_state(output, InputState.Spendable)
+                    self.reservations.pop(index, None)
+
+            # Only spending an input is written to the database.
+            if spent:
+                self.persist()
 
     def prepare_send(
         self,
@@ -264,31 +573,68 @@ class WatchWallet:
         If inputs are passed in, those inputs are used.
         Else, the WatchWallet's inputs are used.
         The selected inputs from the list of inputs have their state updated to Transmitted.
+        They stay reserved until the send is finalized or reservation_timeout seconds pass.
+        Sends can be prepared from multiple threads, each reserving different inputs.
 
         Creates two outputs: one to the destination and a change address.
         The change address is the root view and spend key as a standard address.
         Also finds valid mixins and gets the needed information surrounding them.
 
         Returns the context to be passed to the cold wallet's sign.
+        Crypto.encode_context converts it to a compact binary format for transport.
 
         Raises BalanceError if there isn't enough of a balance to cover the transaction.
         Raises MixinError if there aren't enough mixins to use.
         Raises FeeError if the the fee is too low.
         """
 
-        # Grab the inputs to use.
-        inputs: Dict[OutputIndex, OutputInfo] = self.inputs
-        if inputs_override is not None:
-            inputs = inputs_override
+        return self.prepare_payout(
+            [(dest, amount)], fee, minimum_input, inputs_override
+        )
 
-        # Create the context.
-        context: Dict[str, Any] = {
-            "inputs": [],
-            "mixins": [],
-            "ring": [],
-            "outputs": [],
-            "fee": fee,
-        }
+    def prepare_sends(
+        self,
+        payouts: List[Tuple[Address, int]],
+        fee: Optional[int] = None,
+        minimum_input: int = 0,
+        inputs_override: Optional[Dict[OutputIndex, OutputInfo]] = None,
+    ) -> List[Dict[str, Any]]:
+        """
+        Prepares sends to every destination in payouts.
+        Destinations are packed MAX_DESTINATIONS to a Transaction, in order.
+        The fee is per Transaction. If it's None, each Transaction pays its minimum fee.
+
+        Returns a List of contexts, one per Transaction, each to be passed to the cold wallet's sign.
+
+        If any Transaction can't be prepared, the inputs selected for the prior ones
+        are made Spendable again and the error is raised.
+        """
+
+        contexts: List[Dict[str, Any]] = []
+        try:
+            for p in range(0, len(payouts), MAX_DESTINATIONS):
+                contexts.append(
+                    self.prepare_payout(
+                        payouts[p : p + MAX_DESTINATIONS],
+                        fee,
+                        minimum_input,
+                        inputs_override,
+                    )
+                )
+        except Exception as e:
+            for context in contexts:
+                self.settle(
+                    WatchWallet.context_inputs(context), context["reservation"], False
+                )
+            raise e
+
+        return contexts
+
+    def newest_txo(self) -> Tuple[int, int]:
+        """
+        Get the height and the newest unlocked TXO.
+        Raises MixinError if there aren't enough mixins to use.
+        """
 
         # Grab the height:
         height: int = self.rpc.get_block_count()
@@ -303,34 +649,33 @@ class WatchWallet:
         newest_txo: int = self.rpc.get_o_indexes(newest_tx)[-1]
 
         # Check there's enough mixins available.
-        mixins_available: int = newest_txo - self.crypto.oldest_txo
-        if mixins_available < self.crypto.required_mixins:
+        if newest_txo - self.crypto.oldest_txo < self.crypto.required_mixins:
             raise MixinError("Not enough mixins available.")
-        mixin_bytes: int = ((mixins_available.bit_length() // 8) + 1) * 8
+        return (height, newest_txo)
 
-        # Needed transaction value.
-        value: int = amount + fee
-        for index in inputs:
-            if (
-                # Skip the Input if it's not spendable.
-                (inputs[index].state != InputState.Spendable)
-                or
-                # Skip the Input if it's timelocked.
-                (inputs[index].timelock >= height)
-                or
-                # Skip the Input if it's dust.
-                (inputs[index].amount < minimum_input)
-            ):
-                continue
+    def add_inputs(
+        self, context: Dict[str, Any], selected: List[OutputInfo], newest_txo: int
+    ) -> None:
+        """
+        Adds the selected inputs to the context, along with their mixins and rings.
+        Every ring is fetched at once.
+        """
+
+        mixins_available: int = newest_txo - self.crypto.oldest_txo
+        mixin_bytes: int = ((mixins_available.bit_length() // 8) + 1) * 8
 
+        o_indexes: Dict[bytes, List[int]] = {}
+        for output in selected:
             # Add the input.
-            context["inputs"].append(inputs[index].to_json())
+            context["inputs"].append(output.to_json())
 
             # Grab mixins.
             # Start by getting and adding the Input's actual index.
-            actual: int = self.rpc.get_o_indexes(inputs[index].index.tx_hash)[
-                inputs[index].index.index
-            ]
+            if output.index.tx_hash not in o_indexes:
+                o_indexes[output.index.tx_hash] = self.rpc.get_o_indexes(
+                    output.index.tx_hash
+                )
+            actual: int = o_indexes[output.index.tx_hash][output.index.index]
             context["mixins"].append([actual])
 
             # Add the other mixins.
@@ -348,70 +693,290 @@ class WatchWallet:
             # Specify the input's index to the mixins.
             context["inputs"][-1]["mixin_index"] = context["mixins"][-1].index(actual)
 
-            # Add the ring info..
-            context["ring"].append([])
-            for m in range(len(context["mixins"][-1])):
-                outs: Dict[str, Any] = self.rpc.get_outs(context["mixins"][-1][m])
-                context["ring"][-1].append([outs["key"].hex(), outs["mask"].hex()])
+        # Add the ring info.
+        outs: List[Dict[str, Any]] = self.rpc.get_outs_many(
+            [mixin for mixins in context["mixins"] for mixin in mixins]
+        )
+        for mixins in context["mixins"]:
+            context["ring"].append(
+                [[out["key"].hex(), out["mask"].hex()] for out in outs[: len(mixins)]]
+            )
+            outs = outs[len(mixins) :]
 
-            # Subtract the amount from the needed value.
-            value -= inputs[index].amount
+    def prepare_payout(
+        self,
+        payouts: List[Tuple[Address, int]],
+        fee: Optional[int] = None,
+        minimum_input: int = 0,
+        inputs_override: Optional[Dict[OutputIndex, OutputInfo]] = None,
+    ) -> Dict[str, Any]:
+        """
+        Prepares a single Transaction paying every destination in payouts.
+        Accepts up to MAX_DESTINATIONS destinations, as one more output is needed for change.
+        All outputs share one aggregated range proof.
+        If the fee is None, the minimum fee for the selected inputs is used.
 
-            # Break if we have enough funds.
-            if value <= 0:
-                break
+        Otherwise behaves as prepare_send.
+        """
 
-        # Make sure we have enough funds.
-        if value > 0:
-            raise BalanceError(
-                "Didn't have enough of a balance to cover the transaction."
-            )
+        if not payouts:
+            raise Exception("No destinations were specified.")
+        if len(payouts) > MAX_DESTINATIONS:
+            raise Exception("Too many destinations for a single Transaction.")
 
-        # Make sure the fee is high enough.
-        if fee < self.crypto.get_minimum_fee(
-            self.rpc.get_fee_estimate(),
-            len(context["inputs"]),
-            2,
-            context["mixins"],
-            255,
-            fee,
-        ):
-            raise Exception(FeeError, "Fee is too low.")
+        # Grab the inputs to use.
+        index: InputIndex = self.input_index
+        if inputs_override is not None:
+            index = InputIndex(inputs_override.values())
 
-        # Mark the inputs as transmitted.
-        for input in context["inputs"]:
-            inputs[
-                OutputIndex(bytes.fromhex(input["hash"]), input["index"])
-            ].state = InputState.Transmitted
+        # Create the context.
+        context: Dict[str, Any] = {
+            "inputs": [],
+            "mixins": [],
+            "ring": [],
+            "outputs": [],
+            "fee": fee,
+        }
 
-        # Add the output.
-        address: Address = dest
-        context["outputs"].append({"address": address.address, "amount": amount})
+        # Grab the height and newest TXO.
+        height: int
+        newest_txo: int
+        height, newest_txo = self.newest_txo()
+
+        # Amount of outputs, including change, and a bound on the extra's length.
+        # Every output past the second may add its own R and encrypted payment ID.
+        outputs: int = len(payouts) + 1
+        extra: int = 255 + (41 * (outputs - 2))
+        fee_estimate: Tuple[int, int] = self.rpc.get_fee_estimate()
+
+        # Needed transaction value for an amount of inputs.
+        amount: int = sum([payout[1] for payout in payouts])
+
+        def required(count: int) -> int:
+            if fee is not None:
+                return amount + fee
+            return amount + self.fee_bound(
+                fee_estimate, count, outputs, extra, newest_txo
+            )
+
+        # Select and reserve the inputs.
+        # Only selection happens under the lock, so sends can be prepared in parallel.
+        selected: List[OutputInfo]
+        with self.reservation_lock:
+            self.expire_reservations()
+            selected = index.select(required, height, minimum_input)
+            if not selected:
+                raise BalanceError(
+                    "Didn't have enough of a balance to cover the transaction."
+                )
+            context["reservation"] = self.reserve(selected)
+
+        try:
+            self.add_inputs(context, selected, newest_txo)
+
+            # Make sure the fee is high enough.
+            if fee is None:
+                context["fee"] = self.crypto.get_minimum_fee(
+                    fee_estimate,
+                    len(context["inputs"]),
+                    outputs,
+                    context["mixins"],
+                    extra,
+                    2 ** 64 - 1,
+                )
+            elif fee < self.crypto.get_minimum_fee(
+                fee_estimate,
+                len(context["inputs"]),
+                outputs,
+                context["mixins"],
+                extra,
+                fee,
+            ):
+                raise Exception(FeeError, "Fee is too low.")
+        except Exception as e:
+            self.settle(
+                [output.index for output in selected], context["reservation"], False
+            )
+            raise e
+
+        # Add the outputs.
+        for payout in payouts:
+            address: Address = payout[0]
+            context["outputs"].append({"address": address.address, "amount": payout[1]})
 
         # Return the context and amount of used Transactions.
         return context
 
+    def fee_bound(
+        self,
+        fee_estimate: Tuple[int, int],
+        inputs: int,
+        outputs: int,
+        extra: int,
+        newest_txo: int,
+    ) -> int:
+        """
+        Bound the minimum fee of a Transaction before its mixins are chosen.
+        Uses the largest possible fee's length and every ring offset being the newest TXO.
+        """
+
+        bound: List[int] = [
+            newest_txo * (m + 1) for m in range(self.crypto.required_mixins)
+        ]
+        return self.crypto.get_minimum_fee(
+            fee_estimate, inputs, outputs, [bound] * inputs, extra, 2 ** 64 - 1
+        )
+
+    def prepare_sweep(
+        self,
+        dest: Address,
+        maximum_input: int,
+        inputs_override: Optional[Dict[OutputIndex, OutputInfo]] = None,
+    ) -> List[Dict[str, Any]]:
+        """
+        Prepares sends consolidating every output with an amount less than maximum_input.
+        Outputs worth less than the fee of adding them as an input are left alone.
+        The largest outputs are swept first, in Transactions of MAX_SWEEP_INPUTS inputs.
+        This spreads the fixed cost of each Transaction over as many inputs as possible.
+        Each Transaction pays its minimum fee and sends the rest to dest.
+        As two outputs are required, the rest is split over two outputs.
+
+        Returns a List of contexts, one per Transaction, each to be passed to the cold wallet's sign.
+        The selected inputs have their state updated to Transmitted.
+
+        Raises MixinError if there aren't enough mixins to use.
+        """
+
+        # Grab the inputs to use.
+        index: InputIndex = self.input_index
+        if inputs_override is not None:
+            index = InputIndex(inputs_override.values())
+
+        height: int
+        newest_txo: int
+        height, newest_txo = self.newest_txo()
+        fee_estimate: Tuple[int, int] = self.rpc.get_fee_estimate()
+
+        # Skip outputs which cost more to spend than they're worth.
+        marginal: int = self.fee_bound(
+            fee_estimate, 2, 2, 255, newest_txo
+        ) - self.fee_bound(fee_estimate, 1, 2, 255, newest_txo)
+
+        # Select and reserve the inputs for every Transaction.
+        contexts: List[Dict[str, Any]] = []
+        chunks: List[List[OutputInfo]] = []
+        with self.reservation_lock:
+            self.expire_reservations()
+            dust: List[OutputInfo] = [
+                output
+                for output in index.below(maximum_input, height)
+                if output.amount > marginal
+            ]
+            for d in range(0, len(dust), MAX_SWEEP_INPUTS):
+                chunk: List[OutputInfo] = dust[d : d + MAX_SWEEP_INPUTS]
+                if (len(chunk) < 2) or (
+                    sum([output.amount for output in chunk])
+                    - self.fee_bound(fee_estimate, len(chunk), 2, 255, newest_txo)
+                    < 2
+                ):
+                    break
+
+                chunks.append(chunk)
+                contexts.append(
+                    {
+                        "inputs": [],
+                        "mixins": [],
+                        "ring": [],
+                        "outputs": [],
+                        "fee": 0,
+                        "reservation": self.reserve(chunk),
+                    }
+                )
+
+        try:
+            for c in range(len(chunks)):
+                context: Dict[str, Any] = contexts[c]
+                self.add_inputs(context, chunks[c], newest_txo)
+                context["fee"] = self.crypto.get_minimum_fee(
+                    fee_estimate,
+                    len(context["inputs"]),
+                    2,
+                    context["mixins"],
+                    255,
+                    2 ** 64 - 1,
+                )
+                value: int = (
+                    sum([output.amount for output in chunks[c]]) - context["fee"]
+                )
+                context["outputs"] = [
+                    {"address": dest.address, "amount": value // 2},
+                    {"address": dest.address, "amount": value - (value // 2)},
+                ]
+        except Exception as e:
+            for c in range(len(chunks)):
+                self.settle(
+                    [output.index for output in chunks[c]],
+                    contexts[c]["reservation"],
+                    False,
+                )
+            raise e
+
+        return contexts
+
+    def finalize_sends(
+        self, sends: List[Tuple[bool, Dict[str, Any], str]]
+    ) -> List[bool]:
+        """
+        Finalizes multiple sends, each a success flag, context, and serialization.
+        The successfully signed transactions are verified together, as a batch, before any are published.
+        Each one which verifies is then published.
+        Marks used inputs as spent if the transaction is successfully published.
+        Else, marks used inputs as spendable.
+        """
+
+        # Verify the signed transactions.
+        signed: List[int] = [s for s in range(len(sends)) if sends[s][0]]
+        verifying: List[Tuple[bytes, Dict[int, Tuple[bytes, bytes]]]] = []
+        for s in signed:
+            ring: Dict[int, Tuple[bytes, bytes]] = {}
+            context: Dict[str, Any] = sends[s][1]
+            for i in range(len(context["mixins"])):
+                for m in range(len(context["mixins"][i])):
+                    ring[context["mixins"][i][m]] = (
+                        bytes.fromhex(context["ring"][i][m][0]),
+                        bytes.fromhex(context["ring"][i][m][1]),
+                    )
+            verifying.append((bytes.fromhex(sends[s][2]), ring))
+        verified: List[bool] = self.crypto.verify_transactions(verifying)
+
+        results: List[bool] = [False] * len(sends)
+        for s in range(len(signed)):
+            results[signed[s]] = verified[s]
+
+        for s in range(len(sends)):
+            if results[s]:
+                try:
+                    self.rpc.publish_transaction(bytes.fromhex(sends[s][2]))
+                except RPCError:
+                    results[s] = False
+
+            self.settle(
+                WatchWallet.context_inputs(sends[s][1]),
+                sends[s][1].get("reservation"),
+                results[s],
+            )
+        return results
+
     def finalize_send(
         self, success: bool, context: Dict[str, Any], serialization: str
     ) -> bool:
         """
-        Publishes a signed transaction if success is true.
+        Publishes a signed transaction if success is true and it verifies.
         Marks used inputs as spent if the transaction is successfully published.
         Else, marks used inputs as spendable.
         """
 
-        if success:
-            try:
-                self.rpc.publish_transaction(bytes.fromhex(serialization))
-            except RPCError:
-                success = False
-
-        state = InputState.Spent if success else InputState.Spendable
-        for input_i in context["inputs"]:
-            self.inputs[
-                OutputIndex(bytes.fromhex(input_i["hash"]), input_i["index"])
-            ].state = state
-        return success
+        return self.finalize_sends([(success, context, serialization)])[0]
 
 
 class Wallet:
@@ -432,63 +997,65 @@ class Wallet:
         self.private_view_key: bytes = ed.Hs(self.private_spend_key)
         self.public_view_key: bytes = ed.public_from_secret(self.private_view_key)
 
+        # Subaddress private spend keys, cached across signatures.
+        self.subaddress_keys: Dict[Tuple[int, int], bytes] = {}
+
     def generate_key_images(self, inputs: List[Dict[str, Any]]) -> List[Dict[str, Any]]:
         """Generate a key image for every passed in input."""
 
+        images: List[bytes] = self.crypto.generate_key_images(
+            [self.crypto.output_from_json(input_i) for input_i in inputs],
+            self.private_view_key,
+            self.private_spend_key,
+        )
+
         result: List[Dict[str, Any]] = []
-        for input_i in inputs:
+        for i in range(len(inputs)):
             result.append(
                 {
-                    "hash": input_i["hash"],
-                    "index": input_i["index"],
-                    "image": self.crypto.generate_key_image(
-                        self.crypto.output_from_json(input_i),
-                        self.private_view_key,
-                        self.private_spend_key,
-                    ).hex(),
+                    "hash": inputs[i]["hash"],
+                    "index": inputs[i]["index"],
+                    "image": images[i].hex(),
                 }
             )
         return result
 
-    def sign(self, context: Dict[str, Any]) -> List[str]:
+    def sign(
+        self, context: Union[Dict[str, Any], bytes, bytearray, memoryview]
+    ) -> List[str]:
         """
         Creates a Transaction with a context prepared by a view-only Wallet.
+        The context is either the JSON Dict or its binary encoding from Crypto.encode_context.
         Returns a List of the Transaction hash (as hex) and serialized raw Transaction (as hex).
         """
 
-        # Extract the inputs.
-        inputs: List[OutputInfo] = []
-        for input_i in context["inputs"]:
-            inputs.append(self.crypto.output_from_json(input_i))
-            inputs[-1].index.index = input_i["mixin_index"]
+        # Parse the context.
+        parsed: SigningContext
+        if isinstance(context, dict):
+            parsed = self.parse_context(context)
+        else:
+            parsed = self.crypto.decode_context(context)
+        inputs: List[OutputInfo] = parsed[0]
+        ring: List[List[List[bytes]]] = parsed[2]
 
         # Extract the outputs.
         outputs: List[SpendableOutput] = []
-        for output in context["outputs"]:
-            address: Address = Address.parse(self.crypto, output["address"])
+        for output in parsed[3]:
+            address: Address = Address.parse(self.crypto, output[0])
             outputs.append(
                 SpendableOutput(
                     address.network,
                     address.view_key,
                     address.spend_key,
                     address.payment_id,
-                    output["amount"],
+                    output[1],
                 )
             )
 
-        # Convert the ring to binary.
-        ring: List[List[List[bytes]]] = []
-        for i in range(len(context["ring"])):
-            ring.append([])
-            for v in range(len(context["ring"][i])):
-                ring[i].append([])
-                ring[i][v].append(bytes.fromhex(context["ring"][i][v][0]))
-                ring[i][v].append(bytes.fromhex(context["ring"][i][v][1]))
-
         # Construct a SpendableTransaction from the context.
         sending: SpendableTransaction = self.crypto.spendable_transaction(
             inputs,
-            context["mixins"],
+            parsed[1],
             outputs,
             ring,
             SpendableOutput(
@@ -498,11 +1065,39 @@ class Wallet:
                 None,
                 0,
             ),
-            context["fee"],
+            parsed[4],
         )
 
         # Sign it.
-        self.crypto.sign(sending, self.private_view_key, self.private_spend_key)
+        self.crypto.sign(
+            sending, self.private_view_key, self.private_spend_key, self.subaddress_keys
+        )
 
         result: Tuple[bytes, bytes] = sending.serialize()
         return [result[0].hex(), result[1].hex()]
+
+    def parse_context(self, context: Dict[str, Any]) -> SigningContext:
+        """Parse a JSON context prepared by a view-only Wallet."""
+
+        # Extract the inputs.
+        inputs: List[OutputInfo] = []
+        for input_i in context["inputs"]:
+            inputs.append(self.crypto.output_from_json(input_i))
+            inputs[-1].index.index = input_i["mixin_index"]
+
+        # Convert the ring to binary.
+        ring: List[List[List[bytes]]] = []
+        for i in range(len(context["ring"])):
+            ring.append([])
+            for v in range(len(context["ring"][i])):
+                ring[i].append([])
+                ring[i][v].append(bytes.fromhex(context["ring"][i][v][0]))
+                ring[i][v].append(bytes.fromhex(context["ring"][i][v][1]))
+
+        return (
+            inputs,
+            context["mixins"],
+            ring,
+            [(output["address"], output["amount"]) for output in context["outputs"]],
+            context["fee"],
+        )
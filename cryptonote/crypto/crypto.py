@@ -121,6 +121,22 @@ class SpendableTransaction(ABC):
         """Serialize a SpendableTransaction."""
 
 
+# Parsed signing context.
+# Inputs (indexed by their position in their ring), mixins, ring, outputs (address and amount), and fee.
+SigningContext = Tuple[
+    List[OutputInfo],
+    List[List[int]],
+    List[List[List[bytes]]],
+    List[Tuple[str, int]],
+    int,
+]
+
+# Scanned Transaction.
+# Shared keys, one per R, and for each shared key, the spend key of each output.
+# Spend keys are None for coins which derive them per output.
+ScannedTransaction = Tuple[List[bytes], Optional[List[List[bytes]]]]
+
+
 class Crypto(ABC):
     """
     Crypto class.
@@ -205,6 +221,17 @@ class Crypto(ABC):
         Returns the key pair, payment ID, network byte, and unique factor to watch for.
         """
 
+    def new_addresses(
+        self, key_pair: Tuple[bytes, bytes], major: int, start: int, count: int
+    ) -> List[Tuple[Tuple[bytes, bytes], bytes, str]]:
+        """
+        Constructs the subaddresses (major, start) to (major, start + count - 1).
+        Returns each key pair, network byte, and encoded address.
+        Only subaddress coins support this.
+        """
+
+        raise Exception("This coin doesn't have subaddresses.")
+
     @abstractmethod
     def get_payment_IDs(
         self,
@@ -217,6 +244,19 @@ class Crypto(ABC):
     def create_shared_key(self, scalar: bytes, point: bytes) -> bytes:
         """Created the shared key of which there is one per R."""
 
+    def scan_transactions(
+        self, scalar: bytes, txs: List[Transaction], variable_time: bool = False
+    ) -> List[ScannedTransaction]:
+        """
+        Create the shared keys of many Transactions.
+        Coins which can batch scanning also return the spend key of each output.
+        variable_time allows a faster derivation whose timing depends on the scalar.
+        """
+
+        return [
+            ([self.create_shared_key(scalar, R) for R in tx.Rs], None) for tx in txs
+        ]
+
     @abstractmethod
     def can_spend_output(
         self,
@@ -224,8 +264,12 @@ class Crypto(ABC):
         shared_key: bytes,
         tx: Transaction,
         o: int,
+        spend_key: Optional[bytes] = None,
     ) -> Optional[OutputInfo]:
-        """Checks if an output is spendable and returns the relevant info."""
+        """
+        Checks if an output is spendable and returns the relevant info.
+        The output's spend key is derived unless it was already found by scan_transactions.
+        """
 
     @abstractmethod
     def get_minimum_fee(
@@ -249,16 +293,40 @@ class Crypto(ABC):
 
     @abstractmethod
     def generate_input_key(
-        self, output: OutputInfo, private_view_key: bytes, private_spend_key: bytes
+        self,
+        output: OutputInfo,
+        private_view_key: bytes,
+        private_spend_key: bytes,
+        subaddress_keys: Optional[Dict[Tuple[int, int], bytes]] = None,
     ) -> bytes:
-        """Generate the one-time private key associated with an input."""
+        """
+        Generate the one-time private key associated with an input.
+        Subaddress private spend keys are cached in subaddress_keys, if passed.
+        """
 
     @abstractmethod
     def generate_key_image(
-        self, output: OutputInfo, private_view_key: bytes, private_spend_key: bytes
+        self,
+        output: OutputInfo,
+        private_view_key: bytes,
+        private_spend_key: bytes,
+        subaddress_keys: Optional[Dict[Tuple[int, int], bytes]] = None,
     ) -> bytes:
         """Calculate the key image for the specified input."""
 
+    def generate_key_images(
+        self,
+        outputs: List[OutputInfo],
+        private_view_key: bytes,
+        private_spend_key: bytes,
+    ) -> List[bytes]:
+        """Calculate the key images for the specified inputs."""
+
+        return [
+            self.generate_key_image(output, private_view_key, private_spend_key)
+            for output in outputs
+        ]
+
     @abstractmethod
     def spendable_transaction(
         self,
@@ -271,11 +339,41 @@ class Crypto(ABC):
     ) -> SpendableTransaction:
         """Create a SpendableTransaction."""
 
+    def verify_transactions(
+        self, transactions: List[Tuple[bytes, Dict[int, Tuple[bytes, bytes]]]]
+    ) -> List[bool]:
+        """
+        Verify serialized Transactions before they're published.
+        Each Transaction is passed with its ring members (global index to key and commitment).
+        Coins without local verification consider every Transaction valid.
+        """
+
+        return [True] * len(transactions)
+
+    def encode_context(self, context: Dict[str, Any]) -> bytes:
+        """
+        Encode a context prepared by a WatchWallet in a binary format.
+        Coins without a binary format raise.
+        """
+
+        raise Exception("This coin doesn't have a binary context format.")
+
+    def decode_context(
+        self, data: Union[bytes, bytearray, memoryview]
+    ) -> SigningContext:
+        """Decode a binary context."""
+
+        raise Exception("This coin doesn't have a binary context format.")
+
     @abstractmethod
     def sign(
         self,
         tx: SpendableTransaction,
         private_view_key: bytes,
         private_spend_key: bytes,
+        subaddress_keys: Optional[Dict[Tuple[int, int], bytes]] = None,
     ) -> None:
-        """Sign a SpendableTransaction."""
+        """
+        Sign a SpendableTransaction.
+        Subaddress private spend keys are cached in subaddress_keys, if passed.
+        """
@@ -3,6 +3,9 @@
 # Types.
 from typing import Dict, Set, List, Tuple, Optional, Union, Any
 
+# Enum class.
+from enum import Enum
+
 # urandom standard function.
 from os import urandom
 
@@ -22,14 +25,28 @@ import cryptonote.lib.ed25519 as ed
 import cryptonote.lib.monero_rct as _
 from cryptonote.lib.monero_rct.c_monero_rct import (
     RingCTSignatures,
+    Signer,
+    encode_context,
+    decode_context,
     generate_key_image,
-    generate_ringct_signatures,
+    generate_key_images_many,
+    generate_subaddress_private_spend_key,
+    generate_subaddresses_many,
+    generate_input_key,
+    generate_input_keys_many,
+    get_transaction_weight,
+    verify_transactions,
+    scan_transactions,
+    serialize_transaction_prefix,
+    serialize_transaction,
 )
 
 # Crypto class.
 from cryptonote.crypto.crypto import (
     InputState,
     OutputInfo,
+    SigningContext,
+    ScannedTransaction,
     SpendableOutput,
     SpendableTransaction,
     Crypto,
@@ -39,6 +56,13 @@ from cryptonote.crypto.crypto import (
 from cryptonote.classes.blockchain import MinerOutput, Output, OutputIndex, Transaction
 
 
+class RingCTType(Enum):
+    """RingCT types this library can sign."""
+
+    CLSAG = 5
+    BulletproofPlus = 6
+
+
 class MoneroOutputInfo(OutputInfo):
     def __init__(
         self,
@@ -102,11 +126,13 @@ class MoneroSpendableTransaction(SpendableTransaction):
         output_amounts: List[int],
         extra: bytes,
         fee: int,
+        view_tags: bytes,
     ) -> None:
         self.inputs: List[OutputInfo] = inputs
 
         self.amount_keys: List[bytes] = amount_keys
         self.output_keys: List[bytes] = output_keys
+        self.view_tags: bytes = view_tags
         self.output_amounts: List[int] = output_amounts
 
         self.extra = extra
@@ -116,94 +142,31 @@ class MoneroSpendableTransaction(SpendableTransaction):
 
     @property
     def hash(self) -> bytes:
-        """Get the hash of a MoneroSpendableTransaction."""
-
-    def serialize(self) -> Tuple[bytes, bytes]:
-        """Serialize a MoneroSpendableTransaction."""
-
-        # Serialize the version and lock time.
-        prefix: bytes = bytes([2, 0])
+        """Get the hash of a signed MoneroSpendableTransaction."""
 
-        prefix += to_var_int(len(self.inputs))
-        for input_i in self.inputs:
-            prefix += bytes([2, 0])
-            prefix += to_var_int(len(input_i.mixins))
-            for mixin in input_i.mixins:
-                prefix += to_var_int(mixin)
-            prefix += input_i.image
-
-        prefix += to_var_int(len(self.output_keys))
-        for o in range(len(self.output_keys)):
-            prefix += bytes([0, 2])
-            prefix += self.output_keys[o]
+        if self.signatures is None:
+            raise Exception("MoneroSpendableTransaction hasn't been signed.")
+        return self.serialize()[0]
 
-        prefix += to_var_int(len(self.extra))
-        prefix += self.extra
+    def serialize(self) -> Tuple[bytes, bytes]:
+        """
+        Serialize a MoneroSpendableTransaction.
+        Returns the Transaction hash and serialization.
+        If it hasn't been signed, returns the prefix hash and an empty serialization.
+        """
 
+        inputs: List[Tuple[List[int], bytes]] = [
+            (input_i.mixins, input_i.image) for input_i in self.inputs
+        ]
         if self.signatures is None:
-            return (ed.H(prefix), bytes())
-
-        # RangeCT below. All of our Transactions are Simple Padded Bulletproofs (type 4).
-        base: bytes = bytes([5])
-        base += to_var_int(self.fee)
-
-        for o in range(len(self.output_keys)):
-            for i in range(8):
-                base += bytes([self.signatures.ecdh_info[o].amount[i]])
-
-        for out_public_key in self.signatures.out_public_keys:
-            for i in range(32):
-                base += bytes([out_public_key.mask[i]])
-
-        # Prunable info.
-        prunable: bytes = to_var_int(len(self.signatures.prunable.bulletproofs))
-        for bulletproof in self.signatures.prunable.bulletproofs:
-            for i in range(32):
-                prunable += bytes([bulletproof.capital_a[i]])
-            for i in range(32):
-                prunable += bytes([bulletproof.s[i]])
-            for i in range(32):
-                prunable += bytes([bulletproof.t1[i]])
-            for i in range(32):
-                prunable += bytes([bulletproof.t2[i]])
-            for i in range(32):
-                prunable += bytes([bulletproof.taux[i]])
-            for i in range(32):
-                prunable += bytes([bulletproof.mu[i]])
-
-            prunable += to_var_int(len(bulletproof.l))
-            for l in bulletproof.l:
-                for i in range(32):
-                    prunable += bytes([l[i]])
-
-            prunable += to_var_int(len(bulletproof.r))
-            for r in bulletproof.r:
-                for i in range(32):
-                    prunable += bytes([r[i]])
-
-            for i in range(32):
-                prunable += bytes([bulletproof.a[i]])
-            for i in range(32):
-                prunable += bytes([bulletproof.b[i]])
-            for i in range(32):
-                prunable += bytes([bulletproof.t[i]])
-
-        for cl in self.signatures.prunable.CLSAGs:
-            for s in cl.s:
-                for i in range(32):
-                    prunable += bytes([s[i]])
-            for i in range(32):
-                prunable += bytes([cl.c1[i]])
-            for i in range(32):
-                prunable += bytes([cl.D[i]])
-
-        for pseudo_out in self.signatures.prunable.pseudo_outs:
-            for i in range(32):
-                prunable += bytes([pseudo_out[i]])
-
-        return (
-            ed.H(ed.H(prefix) + ed.H(base) + ed.H(prunable)),
-            prefix + base + prunable,
+            return (
+                serialize_transaction_prefix(
+                    inputs, self.output_keys, self.view_tags, self.extra
+                )[0],
+                bytes(),
+            )
+        return serialize_transaction(
+            inputs, self.output_keys, self.view_tags, self.extra, self.signatures
         )
 
 
@@ -213,8 +176,15 @@ class MoneroCrypto(Crypto):
     Implements the various cryptographic operations used by Monero.
     """
 
-    def __init__(self, mainnet: bool = True):
-        """Initializes the various network properties of the Monero network."""
+    def __init__(self, mainnet: bool = True, rct_type: RingCTType = RingCTType.CLSAG):
+        """
+        Initializes the various network properties of the Monero network.
+        The RingCT type decides the range proofs used by signed Transactions.
+        """
+
+        self.rct_type_property: RingCTType = rct_type
+        # Native signing context, reused for every Transaction this instance signs.
+        self.signer: Signer = Signer(rct_type.value)
 
         if mainnet:
             self.network_bytes_property: List[bytes] = [
@@ -248,6 +218,12 @@ class MoneroCrypto(Crypto):
 
         return 1
 
+    @property
+    def rct_type(self) -> RingCTType:
+        """RingCT type used when signing Transactions."""
+
+        return self.rct_type_property
+
     @property
     def network_bytes(self):
         """
@@ -312,6 +288,14 @@ class MoneroCrypto(Crypto):
 
         return self.confirmations_property
 
+    def warm_up(self) -> None:
+        """
+        Perform the signer's one-time precomputation.
+        Without this, the first signature of the process pays for it.
+        """
+
+        self.signer.warm_up()
+
     def output_from_json(self, output: Dict[str, Any]) -> MoneroOutputInfo:
         """Load a MoneroOutputInfo from JSON."""
 
@@ -349,6 +333,33 @@ class MoneroCrypto(Crypto):
         else:
             raise Exception("Invalid unique factor.")
 
+    def new_addresses(
+        self, key_pair: Tuple[bytes, bytes], major: int, start: int, count: int
+    ) -> List[Tuple[Tuple[bytes, bytes], bytes, str]]:
+        """
+        Constructs the subaddresses (major, start) to (major, start + count - 1).
+        The keys are derived and encoded natively, over every core.
+        Returns each key pair, network byte, and encoded address.
+        """
+
+        result: List[Tuple[Tuple[bytes, bytes], bytes, str]] = []
+        for i, (view_key, spend_key, address) in enumerate(
+            generate_subaddresses_many(
+                key_pair[0],
+                key_pair[1],
+                major,
+                start,
+                count,
+                (self.network_bytes[0], self.network_bytes[2]),
+            )
+        ):
+            # (0, 0) is the standard address.
+            network_byte: bytes = self.network_bytes[2]
+            if (major, start + i) == (0, 0):
+                network_byte = self.network_bytes[0]
+            result.append(((view_key, spend_key), network_byte, address))
+        return result
+
     def get_payment_IDs(
         self,
         shared_keys: List[bytes],
@@ -363,12 +374,25 @@ class MoneroCrypto(Crypto):
         """Created the shared key of which there is one per R."""
 
         # 8Ra.
-        Ra8: Any = ed.scalarmult(ed.decodepoint(point), ed.decodeint(scalar))
-        Ra8 = ed.decompress(Ra8)
-        for _ in range(3):
-            Ra8 = ed.add(Ra8, Ra8)
-        Ra8 = ed.encodepoint(ed.compress(Ra8))
-        return Ra8
+        return ed.generate_key_derivation(point, scalar)
+
+    def scan_transactions(
+        self, scalar: bytes, txs: List[Transaction], variable_time: bool = False
+    ) -> List[ScannedTransaction]:
+        """
+        Create the shared keys of many Transactions, and the spend key of each output, natively.
+        Raises if an R or output key isn't a valid point, as create_shared_key does.
+        variable_time derives the shared keys with a wNAF whose timing depends on the scalar.
+        """
+
+        return [
+            (shared_keys, spend_keys)
+            for shared_keys, spend_keys in scan_transactions(
+                scalar,
+                [(tx.Rs, [output.key for output in tx.outputs]) for tx in txs],
+                variable_time=variable_time,
+            )
+        ]
 
     def can_spend_output(
         self,
@@ -376,6 +400,7 @@ class MoneroCrypto(Crypto):
         shared_key: bytes,
         tx: Transaction,
         o: int,
+        spend_key: Optional[bytes] = None,
     ) -> Optional[MoneroOutputInfo]:
         """Checks if an output is spendable and returns the relevant info."""
 
@@ -389,12 +414,8 @@ class MoneroCrypto(Crypto):
         amount_key: bytes = ed.Hs(shared_key + to_var_int(o))
 
         # P - Hs(8Ra || i)G
-        amount_key_G: ed.CompressedPoint = ed.scalarmult(ed.B, ed.decodeint(amount_key))
-        # Make it negative so it can be subtracted by adding it.
-        amount_key_G = (-amount_key_G[0], amount_key_G[1])
-        spend_key: bytes = ed.encodepoint(
-            ed.add_compressed(ed.decodepoint(output.key), amount_key_G)
-        )
+        if spend_key is None:
+            spend_key = ed.sub_keys(output.key, ed.scalarmult_base(amount_key))
 
         # We now have the spend key of the Transaction.
         if spend_key in unique_factors:
@@ -415,18 +436,7 @@ class MoneroCrypto(Crypto):
                 # The encrypted amount is malleable.
                 # We need to rebuild the commitment to verify it's accurate.
                 commitment = ed.Hs(b"commitment_mask" + amount_key)
-                if (
-                    ed.encodepoint(
-                        ed.add_compressed(
-                            ed.scalarmult(
-                                ed.B,
-                                ed.decodeint(commitment),
-                            ),
-                            ed.scalarmult(ed.C, amount),
-                        )
-                    )
-                    != output.commitment
-                ):
+                if ed.commit(amount, commitment) != output.commitment:
                     return None
 
             return MoneroOutputInfo(
@@ -459,44 +469,63 @@ class MoneroCrypto(Crypto):
         - Fee (a bit ironic, yet the fee changes the serialization length)
         """
 
-        # Calculate the Transaction length.
-        length: int = len(to_var_int(inputs)) + (803 * inputs)
-        for i in mixins:
-            for v in i:
-                length += len(to_var_int(v))
-        length += len(to_var_int(outputs)) + (74 * outputs)
-        length += len(to_var_int(extra)) + extra
-        length += len(to_var_int(fee))
-
-        length += 64 * min(outputs, 4)
-        length += 614
+        # Calculate the Transaction weight.
+        if len(mixins) != inputs:
+            raise Exception("Mixins weren't provided for every input.")
+        weight: int = get_transaction_weight(
+            mixins, outputs, extra, fee, self.rct_type_property.value
+        )
 
         # Calculate and return the minimum fee.
         return (
-            ((length * minimum_fee[0]) + minimum_fee[1] - 1)
+            ((weight * minimum_fee[0]) + minimum_fee[1] - 1)
             // minimum_fee[1]
             * minimum_fee[1]
         )
 
+    def generate_subaddress_private_spend_key(
+        self,
+        private_view_key: bytes,
+        private_spend_key: bytes,
+        index: Tuple[int, int],
+        subaddress_keys: Optional[Dict[Tuple[int, int], bytes]] = None,
+    ) -> bytes:
+        """
+        Generate the private spend key for a subaddress.
+        If a cache is passed, it's checked first and updated with the result.
+        """
+
+        if (subaddress_keys is not None) and (index in subaddress_keys):
+            return subaddress_keys[index]
+
+        result: bytes = generate_subaddress_private_spend_key(
+            private_view_key, private_spend_key, index
+        )
+        if subaddress_keys is not None:
+            subaddress_keys[index] = result
+        return result
+
     def generate_input_key(
         self,
         output: OutputInfo,
         private_view_key: bytes,
         private_spend_key: bytes,
+        subaddress_keys: Optional[Dict[Tuple[int, int], bytes]] = None,
     ) -> bytes:
-        """Generate the one-time private key associated with an input."""
+        """
+        Generate the one-time private key associated with an input.
+        Subaddress private spend keys are cached in subaddress_keys, if passed.
+        """
 
         if isinstance(output, MoneroOutputInfo):
-            return ed.encodeint(
-                (
-                    ed.decodeint(output.amount_key)
-                    + ed.generate_subaddress_private_spend_key(
-                        private_view_key,
-                        private_spend_key,
-                        output.subaddress,
-                    )
-                )
-                % ed.l
+            return generate_input_key(
+                output.amount_key,
+                self.generate_subaddress_private_spend_key(
+                    private_view_key,
+                    private_spend_key,
+                    self.input_subaddress(output),
+                    subaddress_keys,
+                ),
             )
         else:
             raise Exception("MoneroCrypto handed a non-Monero OutputInfo.")
@@ -506,13 +535,115 @@ class MoneroCrypto(Crypto):
         output: OutputInfo,
         private_view_key: bytes,
         private_spend_key: bytes,
+        subaddress_keys: Optional[Dict[Tuple[int, int], bytes]] = None,
     ) -> bytes:
         """Calculate the key image for the specified input."""
 
-        input_key: bytes = self.generate_input_key(
-            output, private_view_key, private_spend_key
+        return generate_key_image(
+            self.generate_input_key(
+                output, private_view_key, private_spend_key, subaddress_keys
+            )
+        )
+
+    def generate_key_images(
+        self,
+        outputs: List[OutputInfo],
+        private_view_key: bytes,
+        private_spend_key: bytes,
+    ) -> List[bytes]:
+        """
+        Calculate the key images for the specified inputs.
+        Derives the one-time keys and key images natively, over every core.
+        """
+
+        subaddresses: List[Tuple[bytes, Tuple[int, int]]] = []
+        for output in outputs:
+            if isinstance(output, MoneroOutputInfo):
+                subaddresses.append((output.amount_key, self.input_subaddress(output)))
+            else:
+                raise Exception("MoneroCrypto handed a non-Monero OutputInfo.")
+
+        return generate_key_images_many(
+            private_view_key, private_spend_key, subaddresses
+        )
+
+    def input_subaddress(self, output: MoneroOutputInfo) -> Tuple[int, int]:
+        """Subaddress whose private spend key is part of the output's one-time key."""
+
+        return output.subaddress
+
+    def verify_transactions(
+        self, transactions: List[Tuple[bytes, Dict[int, Tuple[bytes, bytes]]]]
+    ) -> List[bool]:
+        """
+        Verify serialized Transactions before they're published.
+        Each Transaction is passed with its ring members (global index to key and commitment).
+        Their range proofs are verified as a single batch.
+        """
+
+        return verify_transactions(transactions)
+
+    def encode_context(self, context: Dict[str, Any]) -> bytes:
+        """
+        Encode a context prepared by a WatchWallet in the binary format.
+        Keys and hashes are raw bytes and every integer is a VarInt, about halving its size.
+        """
+
+        return encode_context(
+            context["fee"],
+            [
+                (
+                    bytes.fromhex(input_i["hash"]),
+                    input_i["index"],
+                    input_i["timelock"],
+                    input_i["amount"],
+                    bytes.fromhex(input_i["spend_key"]),
+                    (input_i["subaddress"][0], input_i["subaddress"][1]),
+                    bytes.fromhex(input_i["amount_key"]),
+                    bytes.fromhex(input_i["commitment"]),
+                    input_i["state"],
+                    input_i["mixin_index"],
+                )
+                for input_i in context["inputs"]
+            ],
+            context["mixins"],
+            [
+                [
+                    [bytes.fromhex(member[0]), bytes.fromhex(member[1])]
+                    for member in ring
+                ]
+                for ring in context["ring"]
+            ],
+            [(output["address"], output["amount"]) for output in context["outputs"]],
         )
-        return generate_key_image(input_key, ed.public_from_secret(input_key))
+
+    def decode_context(
+        self, data: Union[bytes, bytearray, memoryview]
+    ) -> SigningContext:
+        """Decode a binary context."""
+
+        fee: int
+        inputs: List[Any]
+        mixins: List[List[int]]
+        ring: List[List[List[bytes]]]
+        outputs: List[Tuple[str, int]]
+        fee, inputs, mixins, ring, outputs = decode_context(data)
+
+        infos: List[OutputInfo] = []
+        for input_i in inputs:
+            infos.append(
+                MoneroOutputInfo(
+                    OutputIndex(input_i[0], input_i[9]),
+                    input_i[2],
+                    input_i[3],
+                    input_i[4],
+                    input_i[5],
+                    input_i[6],
+                    input_i[7],
+                )
+            )
+            infos[-1].state = InputState(input_i[8])
+        return (infos, mixins, ring, outputs, fee)
 
     def spendable_transaction(
         self,
@@ -575,26 +706,24 @@ class MoneroCrypto(Crypto):
         amount_keys: List[bytes] = []
         output_keys: List[bytes] = []
         output_amounts: List[int] = []
+        # View tags are only valid alongside BulletproofPlus.
+        view_tags: bytes = bytes()
+        tagged: bool = self.rct_type_property == RingCTType.BulletproofPlus
         for o in range(len(outputs)):
             rA8s.append(self.create_shared_key(r, outputs[o].view_key))
             amount_keys.append(ed.Hs(rA8s[-1] + to_var_int(o)))
+            if tagged:
+                view_tags += ed.H(b"view_tag" + rA8s[-1] + to_var_int(o))[0:1]
 
             output_keys.append(
-                ed.encodepoint(
-                    ed.add_compressed(
-                        ed.scalarmult(ed.B, ed.decodeint(amount_keys[-1])),
-                        ed.decodepoint(outputs[o].spend_key),
-                    )
-                )
+                ed.add_keys(ed.scalarmult_base(amount_keys[-1]), outputs[o].spend_key)
             )
 
             rG: bytes
             if outputs[o].network == self.network_bytes_property[2]:
-                rG = ed.encodepoint(
-                    ed.scalarmult(ed.decodepoint(outputs[o].spend_key), ed.decodeint(r))
-                )
+                rG = ed.scalarmult_key(outputs[o].spend_key, r)
             else:
-                rG = ed.encodepoint(ed.scalarmult(ed.B, ed.decodeint(r)))
+                rG = ed.scalarmult_base(r)
             Rs.append(rG)
 
             output_amounts.append(outputs[o].amount)
@@ -627,7 +756,7 @@ class MoneroCrypto(Crypto):
             )
 
         return MoneroSpendableTransaction(
-            inputs, amount_keys, output_keys, output_amounts, extra, fee
+            inputs, amount_keys, output_keys, output_amounts, extra, fee, view_tags
         )
 
     def sign(
@@ -635,50 +764,69 @@ class MoneroCrypto(Crypto):
         tx: SpendableTransaction,
         private_view_key: bytes,
         private_spend_key: bytes,
+        subaddress_keys: Optional[Dict[Tuple[int, int], bytes]] = None,
     ) -> None:
-        """Sign a MoneroSpendableTransaction."""
+        """
+        Sign a MoneroSpendableTransaction.
+        Subaddress private spend keys are cached in subaddress_keys, if passed.
+        """
 
         if not isinstance(tx, MoneroSpendableTransaction):
             raise Exception("Was told to sign a non-Monero Spendable Transaction.")
 
-        # Generate the key image.
-        for i in range(len(tx.inputs)):
-            tx.inputs[i].image = self.generate_key_image(
-                tx.inputs[i], private_view_key, private_spend_key
+        # Generate the private keys and key images for every input in one native call.
+        # Each private key is derived once, as both the key image and the signature use it.
+        spend_keys: List[Tuple[bytes, bytes]] = []
+        for input_i in tx.inputs:
+            if not isinstance(input_i, MoneroOutputInfo):
+                raise Exception("MoneroCrypto handed a non-Monero OutputInfo.")
+            spend_keys.append(
+                (
+                    input_i.amount_key,
+                    self.generate_subaddress_private_spend_key(
+                        private_view_key,
+                        private_spend_key,
+                        self.input_subaddress(input_i),
+                        subaddress_keys,
+                    ),
+                )
             )
+        signing: List[Tuple[OutputInfo, bytes]] = []
+        for input_i, (key, image) in zip(
+            tx.inputs, generate_input_keys_many(spend_keys)
+        ):
+            signing.append((input_i, key))
+            input_i.image = image
 
         # Sort the inputs by their key images.
-        tx.inputs.sort(key=lambda i: i.image, reverse=True)
+        signing.sort(key=lambda pair: pair[0].image, reverse=True)
+        tx.inputs = [pair[0] for pair in signing]
 
-        # Regenerate the private keys and extract the amounts/indexes/ring.
-        input_keys: List[Tuple[bytes, bytes]] = []
+        # Extract the private keys/amounts/indexes/ring.
+        # The keys and ring are passed as flat buffers so the extension can copy them in bulk.
+        input_keys: List[bytes] = []
         input_amounts: List[int] = []
         input_indexes: List[int] = []
-        ring: List[List[List[bytes]]] = []
-        for input_i in tx.inputs:
+        ring: List[bytes] = []
+        for input_i, key in signing:
             if isinstance(input_i, MoneroOutputInfo):
-                input_keys.append(
-                    (
-                        self.generate_input_key(
-                            input_i, private_view_key, private_spend_key
-                        ),
-                        input_i.commitment,
-                    )
-                )
+                input_keys.append(key)
+                input_keys.append(input_i.commitment)
             else:
                 raise Exception("MoneroCrypto handed a non-Monero OutputInfo.")
 
             input_amounts.append(input_i.amount)
             input_indexes.append(input_i.index.index)
-            ring.append(input_i.ring)
+            for member in input_i.ring:
+                ring += member
 
         # Create the RingCT signatures.
-        tx.signatures = generate_ringct_signatures(
+        tx.signatures = self.signer.sign(
             tx.serialize()[0],
-            input_keys,
-            tx.output_keys,
-            tx.amount_keys,
-            ring,
+            b"".join(input_keys),
+            b"".join(tx.output_keys),
+            b"".join(tx.amount_keys),
+            b"".join(ring),
             input_indexes,
             input_amounts,
             tx.output_amounts,
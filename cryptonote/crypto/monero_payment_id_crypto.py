@@ -8,7 +8,6 @@ import cryptonote.lib.ed25519 as ed
 
 # MoneroCrypto class.
 from cryptonote.crypto.monero_crypto import (
-    OutputInfo,
     MoneroOutputInfo,
     MoneroCrypto,
 )
@@ -54,6 +53,13 @@ class MoneroPaymentIDCrypto(MoneroCrypto):
         else:
             raise Exception("Invalid unique factor.")
 
+    def new_addresses(
+        self, key_pair: Tuple[bytes, bytes], major: int, start: int, count: int
+    ) -> List[Tuple[Tuple[bytes, bytes], bytes, str]]:
+        """Payment ID coins don't have subaddresses."""
+
+        raise Exception("This coin doesn't have subaddresses.")
+
     def get_payment_IDs(
         self,
         shared_keys: List[bytes],
@@ -77,18 +83,7 @@ class MoneroPaymentIDCrypto(MoneroCrypto):
                 )
         return list(result)
 
-    def generate_input_key(
-        self,
-        output: OutputInfo,
-        private_view_key: bytes,
-        private_spend_key: bytes,
-    ) -> bytes:
-        """Generate the one-time private key associated with an input."""
+    def input_subaddress(self, output: MoneroOutputInfo) -> Tuple[int, int]:
+        """Payment ID addresses are always derived from the root spend key."""
 
-        if isinstance(output, MoneroOutputInfo):
-            return ed.encodeint(
-                (ed.decodeint(output.amount_key) + ed.decodeint(private_spend_key))
-                % ed.l
-            )
-        else:
-            raise Exception("MoneroCrypto handed a non-Monero OutputInfo.")
+        return (0, 0)
@@ -17,7 +17,12 @@ class TurtlecoinCrypto(MoneroPaymentIDCrypto):
     """
 
     def __init__(self, mainnet: bool = True):
-        """Initializes the various network properties of the Turtlecoin network."""
+        """
+        Initializes the various network properties of the Turtlecoin network.
+        The native signer and RingCT type are set by MoneroCrypto.
+        """
+
+        MoneroPaymentIDCrypto.__init__(self, mainnet)
 
         self.network_bytes_property: List[bytes] = [
             bytes.fromhex("9df6ee01"),
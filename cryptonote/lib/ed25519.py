@@ -11,6 +11,19 @@ import operator as _oper
 
 from Cryptodome.Hash import keccak
 
+# Native Ed25519 operations, backed by Monero's crypto-ops.
+import cryptonote.lib.monero_rct as _
+from cryptonote.lib.monero_rct.c_monero_rct import (
+    scalarmult_base,
+    scalarmult_key,
+    add_keys,
+    sub_keys,
+    hash_to_scalar,
+    generate_key_derivation,
+    commit,
+    generate_subaddress_key_pair,
+)
+
 indexbytes: Any = _oper.getitem
 int2byte: Any = _oper.methodcaller("to_bytes", 1, "big")
 
@@ -20,12 +33,7 @@ l: int = 2 ** 252 + 27742317777372353535851937790883648493
 
 
 def expmod(b: int, e: int, m: int) -> int:
-    if e == 0:
-        return 1
-    t: int = expmod(b, e // 2, m) ** 2 % m
-    if e & 1:
-        t = (t * b) % m
-    return t
+    return pow(b, e, m)
 
 
 def inv(x: int) -> int:
@@ -90,29 +98,13 @@ def add_compressed(P: CompressedPoint, Q: CompressedPoint) -> CompressedPoint:
     return compress(add(decompress(P), decompress(Q)))
 
 
-def scalarmult(P: CompressedPoint, e: int) -> CompressedPoint:
-    if e == 0:
-        return (0, 1)
-    q = scalarmult(P, e // 2)
-    q = edwards(q, q)
-    if e & 1:
-        q = edwards(q, P)
-    return q
-
-
 def encodeint(y: int) -> bytes:
-    bits = [(y >> i) & 1 for i in range(b)]
-    return b"".join(
-        [int2byte(sum([bits[i * 8 + j] << j for j in range(8)])) for i in range(b // 8)]
-    )
+    return (y % (2 ** b)).to_bytes(b // 8, byteorder="little")
 
 
 def encodepoint(P: CompressedPoint) -> bytes:
-    x = P[0]
-    y = P[1]
-    bits = [(y >> i) & 1 for i in range(b - 1)] + [x & 1]
-    return b"".join(
-        [int2byte(sum([bits[i * 8 + j] << j for j in range(8)])) for i in range(b // 8)]
+    return ((P[1] % (2 ** (b - 1))) | ((P[0] & 1) << (b - 1))).to_bytes(
+        b // 8, byteorder="little"
     )
 
 
@@ -127,11 +119,11 @@ def isoncurve(P: CompressedPoint):
 
 
 def decodeint(s: bytes) -> int:
-    return sum(2 ** i * bit(s, i) for i in range(0, b))
+    return int.from_bytes(s[0 : b // 8], byteorder="little")
 
 
 def decodepoint(s: bytes) -> CompressedPoint:
-    y = sum(2 ** i * bit(s, i) for i in range(0, b - 1))
+    y = decodeint(s) % (2 ** (b - 1))
     x = xrecover(y)
     if x & 1 != bit(s, b - 1):
         x = q - x
@@ -141,10 +133,16 @@ def decodepoint(s: bytes) -> CompressedPoint:
     return P
 
 
+def scalarmult(P: CompressedPoint, e: int) -> CompressedPoint:
+    """eP, with e reduced mod l. Performed natively."""
+
+    if P == B:
+        return decodepoint(scalarmult_base(encodeint(e % l)))
+    return decodepoint(scalarmult_key(encodepoint(P), encodeint(e % l)))
+
+
 def public_from_secret(k: bytes) -> bytes:
-    keyInt = decodeint(k)
-    aB = scalarmult(B, keyInt)
-    return encodepoint(aB)
+    return scalarmult_base(k)
 
 
 # Code added for the CryptoNote library.
@@ -165,7 +163,7 @@ def H(d: bytes) -> bytes:
 def Hs(d: bytes) -> bytes:
     """Keccak-256 mod l."""
 
-    return encodeint(decodeint(H(d)) % l)
+    return hash_to_scalar(d)
 
 
 def generate_subaddress_private_spend_key(
@@ -202,22 +200,9 @@ def generate_subaddress_public_spend_key(
     if subaddress == (0, 0):
         return public_spend_key
 
-    return encodepoint(
-        add_compressed(
-            decodepoint(public_spend_key),
-            scalarmult(
-                B,
-                decodeint(
-                    Hs(
-                        b"SubAddr\0"
-                        + private_view_key
-                        + subaddress[0].to_bytes(4, byteorder="little")
-                        + subaddress[1].to_bytes(4, byteorder="little")
-                    )
-                ),
-            ),
-        )
-    )
+    return generate_subaddress_key_pair(
+        private_view_key, public_spend_key, subaddress
+    )[1]
 
 
 def generate_subaddress_public_view_key(
@@ -231,26 +216,4 @@ def generate_subaddress_public_view_key(
     if subaddress == (0, 0):
         return public_from_secret(private_view_key)
 
-    return encodepoint(
-        scalarmult(decodepoint(public_spend_key), decodeint(private_view_key))
-    )
-
-
-def generate_subaddress_key_pair(
-    private_view_key: bytes, public_spend_key: bytes, subaddress: Tuple[int, int]
-) -> Tuple[bytes, bytes]:
-    """
-    Generate a subaddress public view key using the
-    private view key and subaddress public spend key.
-    """
-
-    subaddress_spend_key: bytes = generate_subaddress_public_spend_key(
-        private_view_key, public_spend_key, subaddress
-    )
-
-    return (
-        generate_subaddress_public_view_key(
-            private_view_key, subaddress_spend_key, subaddress
-        ),
-        subaddress_spend_key,
-    )
+    return scalarmult_key(public_spend_key, private_view_key)
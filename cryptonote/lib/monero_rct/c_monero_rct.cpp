@@ -1,113 +1,2461 @@
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
 #include <vector>
+#include <mutex>
+#include <thread>
+#include <iterator>
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
 
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 
+#include "memwipe.h"
+#include "common/varint.h"
+#include "common/base58.h"
 #include "crypto/crypto.h"
 #include "device/device.hpp"
 #include "device/device_default.hpp"
 
 #include "ringct/bulletproofs.h"
+#include "ringct/bulletproofs_plus.h"
 
 #include "ringct/rctTypes.h"
+#include "ringct/rctOps.h"
 #include "ringct/rctSigs.h"
 
+#include "cryptonote_config.h"
+#include "cryptonote_basic/cryptonote_basic.h"
+#include "cryptonote_basic/cryptonote_format_utils.h"
+
+#include "lmdb.h"
+
+#include "fe51_avx2.h"
+
+//Run f(i) for every i in [0, count) over the specified amount of threads. 0 threads uses every core.
+template<typename F>
+void parallel_for(size_t count, size_t threads, F f) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, count);
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            f(i);
+        }
+        return;
+    }
+
+    size_t chunk = (count + threads - 1) / threads;
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; t++) {
+        size_t start = t * chunk;
+        size_t end = std::min(start + chunk, count);
+        workers.emplace_back([&f, &errors, t, start, end]() {
+            try {
+                for (size_t i = start; i < end; i++) {
+                    f(i);
+                }
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    for (std::exception_ptr &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+//Subaddress secret, Hs("SubAddr\0" || a || major || minor).
+void subaddress_secret(const crypto::secret_key &view, uint32_t major, uint32_t minor, crypto::ec_scalar &result) {
+    uint8_t data[48];
+    memcpy(data, "SubAddr", 8);
+    memcpy(data + 8, view.data, 32);
+    for (int i = 0; i < 4; i++) {
+        data[40 + i] = (major >> (i * 8)) & 0xFF;
+        data[44 + i] = (minor >> (i * 8)) & 0xFF;
+    }
+    crypto::hash_to_scalar(data, 48, result);
+    memwipe(data, 48);
+}
+
+//One-time private key of an output, Hs(8Ra || i) + b, plus the subaddress secret if it wasn't sent to the root address.
+void input_key(
+    const crypto::secret_key &view,
+    const crypto::secret_key &spend,
+    const rct::key &amount_key,
+    uint32_t major,
+    uint32_t minor,
+    crypto::secret_key &result
+) {
+    sc_add((unsigned char*) result.data, amount_key.bytes, (const unsigned char*) spend.data);
+    if ((major != 0) || (minor != 0)) {
+        crypto::ec_scalar subaddress;
+        subaddress_secret(view, major, minor, subaddress);
+        sc_add((unsigned char*) result.data, (const unsigned char*) result.data, (const unsigned char*) subaddress.data);
+        memwipe(subaddress.data, 32);
+    }
+}
+
+//Subaddress private spend key, b + Hs("SubAddr\0" || a || major || minor), or b for the root address.
+pybind11::bytes generate_subaddress_private_spend_key(
+    pybind11::bytes view_key_arg,
+    pybind11::bytes spend_key_arg,
+    std::pair<uint32_t, uint32_t> index
+) {
+    crypto::secret_key view_key;
+    crypto::secret_key spend_key;
+    memcpy(view_key.data, PYBIND11_BYTES_AS_STRING(view_key_arg.ptr()), 32);
+    memcpy(spend_key.data, PYBIND11_BYTES_AS_STRING(spend_key_arg.ptr()), 32);
+
+    //A zero amount key leaves just the (reduced) subaddress private spend key.
+    crypto::secret_key result;
+    input_key(view_key, spend_key, rct::zero(), index.first, index.second, result);
+    return pybind11::bytes(std::string(result.data, 32));
+}
+
+//One-time private key of an output from its amount key and the (subaddress) private spend key, Hs(8Ra || i) + b.
+pybind11::bytes generate_input_key(
+    pybind11::bytes amount_key_arg,
+    pybind11::bytes spend_key_arg
+) {
+    crypto::secret_key result;
+    sc_add(
+        (unsigned char*) result.data,
+        (const unsigned char*) PYBIND11_BYTES_AS_STRING(amount_key_arg.ptr()),
+        (const unsigned char*) PYBIND11_BYTES_AS_STRING(spend_key_arg.ptr())
+    );
+    return pybind11::bytes(std::string(result.data, 32));
+}
+
+//Get a 32-byte key from Python, checking its length.
+const char *key_bytes(const pybind11::bytes &key) {
+    if (PYBIND11_BYTES_SIZE(key.ptr()) != 32) {
+        throw std::invalid_argument("Key isn't 32 bytes.");
+    }
+    return PYBIND11_BYTES_AS_STRING(key.ptr());
+}
+
+//Get a scalar from Python, reduced mod l.
+rct::key scalar_arg(const pybind11::bytes &scalar) {
+    rct::key result;
+    memcpy(result.bytes, key_bytes(scalar), 32);
+    sc_reduce32(result.bytes);
+    return result;
+}
+
+//Get a point from Python. It's validated when it's decompressed.
+rct::key point_arg(const pybind11::bytes &point) {
+    rct::key result;
+    memcpy(result.bytes, key_bytes(point), 32);
+    return result;
+}
+
+//Return a key to Python.
+pybind11::bytes key_result(const rct::key &key) {
+    return pybind11::bytes(std::string((const char*) key.bytes, 32));
+}
+
+//Point operations with Monero's ref10 crypto-ops. Scalars must be reduced. Return false if a point is invalid.
+namespace ref10 {
+    void scalarmult_base(rct::key &result, const rct::key &scalar) {
+        ge_p3 point;
+        ge_scalarmult_base(&point, scalar.bytes);
+        ge_p3_tobytes(result.bytes, &point);
+    }
+
+    bool scalarmult_key(rct::key &result, const rct::key &point, const rct::key &scalar) {
+        ge_p3 decoded;
+        if (ge_frombytes_vartime(&decoded, point.bytes) != 0) {
+            return false;
+        }
+        ge_p2 product;
+        ge_scalarmult(&product, scalar.bytes, &decoded);
+        ge_tobytes(result.bytes, &product);
+        return true;
+    }
+
+    bool add_keys(rct::key &result, const rct::key &p, const rct::key &q, bool subtract) {
+        ge_p3 p_decoded;
+        ge_p3 q_decoded;
+        if ((ge_frombytes_vartime(&p_decoded, p.bytes) != 0) || (ge_frombytes_vartime(&q_decoded, q.bytes) != 0)) {
+            return false;
+        }
+        ge_cached cached;
+        ge_p1p1 sum;
+        ge_p3_to_cached(&cached, &q_decoded);
+        if (subtract) {
+            ge_sub(&sum, &p_decoded, &cached);
+        } else {
+            ge_add(&sum, &p_decoded, &cached);
+        }
+        ge_p1p1_to_p3(&p_decoded, &sum);
+        ge_p3_tobytes(result.bytes, &p_decoded);
+        return true;
+    }
+
+    bool derivation(rct::key &result, const rct::key &point, const rct::key &scalar) {
+        crypto::key_derivation derivation;
+        if (!crypto::generate_key_derivation(rct::rct2pk(point), rct::rct2sk(scalar), derivation)) {
+            return false;
+        }
+        memcpy(result.bytes, derivation.data, 32);
+        return true;
+    }
+
+    void commit(rct::key &result, uint64_t amount, const rct::key &mask) {
+        result = rct::commit(amount, mask);
+    }
+}
+
+#ifdef FE51
+//Point operations with the radix-51 backend.
+namespace radix51 {
+    void scalarmult_base(rct::key &result, const rct::key &scalar) {
+        fe51::scalarmult_base(result.bytes, scalar.bytes);
+    }
+
+    bool scalarmult_key(rct::key &result, const rct::key &point, const rct::key &scalar) {
+        return fe51::scalarmult_key(result.bytes, point.bytes, scalar.bytes);
+    }
+
+    bool add_keys(rct::key &result, const rct::key &p, const rct::key &q, bool subtract) {
+        return fe51::add_keys(result.bytes, p.bytes, q.bytes, subtract);
+    }
+
+    bool derivation(rct::key &result, const rct::key &point, const rct::key &scalar) {
+        return fe51::derivation(result.bytes, point.bytes, scalar.bytes);
+    }
+
+    bool derivation_vartime(rct::key &result, const rct::key &point, const fe51::Wnaf &naf) {
+        return fe51::derivation_vartime(result.bytes, point.bytes, naf);
+    }
+
+    //Uses fixed-base tables for both G and H.
+    void commit(rct::key &result, uint64_t amount, const rct::key &mask) {
+        fe51::commit(result.bytes, amount, mask.bytes);
+    }
+}
+
+//The field backend is chosen at build time. 64-bit targets with 128-bit multiplication use radix-51.
+namespace backend = radix51;
+const char *FIELD_BACKEND = "radix-51";
+#else
+namespace backend = ref10;
+const char *FIELD_BACKEND = "ref10";
+#endif
+
+std::string field_backend() {
+    return FIELD_BACKEND;
+}
+
+//AVX2 is checked for at runtime, so one build runs on CPUs with and without it. It only covers P - sG; see sub_base_many.
+bool vectorized() {
+#ifdef FE51_AVX2
+    return fe51x4::supported();
+#else
+    return false;
+#endif
+}
+
+std::string vector_backend() {
+    return vectorized() ? "avx2" : "scalar";
+}
+
+//Run f on every group of four items. Groups are split over threads and a partial last group is padded with its first item.
+template<typename F>
+void for_each_group(size_t count, size_t threads, F f) {
+    parallel_for((count + 3) / 4, threads, [&f, count](size_t group) {
+        size_t indexes[4];
+        for (size_t l = 0; l < 4; l++) {
+            indexes[l] = (((group * 4) + l) < count) ? ((group * 4) + l) : (group * 4);
+        }
+        f(indexes, std::min(count - (group * 4), (size_t) 4));
+    });
+}
+
+//8aR for many Rs, split over threads. valid is set to 0 for invalid points.
+//AVX2 only helps the fixed-base sub_base_many, so this always uses the selected backend.
+//variable_time uses a wNAF of 8a, recoded once, which leaks timing on a. It's only used with the radix-51 backend.
+void derivations_many(
+    const rct::key &scalar,
+    const std::vector<rct::key> &points,
+    std::vector<rct::key> &results,
+    std::vector<uint8_t> &valid,
+    size_t threads,
+    bool variable_time = false
+) {
+    results.resize(points.size());
+    valid.resize(points.size());
+#ifdef FE51
+    fe51::Wnaf naf;
+    if (variable_time) {
+        fe51::wnaf8(naf, scalar.bytes);
+    }
+#endif
+    parallel_for(points.size(), threads, [&](size_t i) {
+#ifdef FE51
+        if (variable_time) {
+            valid[i] = radix51::derivation_vartime(results[i], points[i], naf);
+            return;
+        }
+#endif
+        valid[i] = backend::derivation(results[i], points[i], scalar);
+    });
+#ifdef FE51
+    memwipe(&naf, sizeof(naf));
+#endif
+}
+
+//P - sG for many Ps and reduced scalars. valid is set to 0 for invalid points. Four at a time with AVX2 when the CPU supports it.
+void sub_base_many(
+    const std::vector<rct::key> &points,
+    const std::vector<rct::key> &scalars,
+    std::vector<rct::key> &results,
+    std::vector<uint8_t> &valid,
+    size_t threads
+) {
+    results.resize(points.size());
+    valid.resize(points.size());
+    for_each_group(points.size(), threads, [&](const size_t indexes[4], size_t used) {
+#ifdef FE51_AVX2
+        if (vectorized()) {
+            unsigned char group_points[4][32];
+            unsigned char group_scalars[4][32];
+            unsigned char group_results[4][32];
+            bool group_valid[4];
+            for (size_t l = 0; l < 4; l++) {
+                memcpy(group_points[l], points[indexes[l]].bytes, 32);
+                memcpy(group_scalars[l], scalars[indexes[l]].bytes, 32);
+            }
+            fe51x4::sub_base(group_results, group_points, group_scalars, group_valid);
+            for (size_t l = 0; l < used; l++) {
+                memcpy(results[indexes[l]].bytes, group_results[l], 32);
+                valid[indexes[l]] = group_valid[l];
+            }
+            return;
+        }
+#endif
+        for (size_t l = 0; l < used; l++) {
+            rct::key sG;
+            backend::scalarmult_base(sG, scalars[indexes[l]]);
+            valid[indexes[l]] = backend::add_keys(results[indexes[l]], points[indexes[l]], sG, true);
+        }
+    });
+}
+
+//Throw if a point operation was passed an invalid point.
+void check_point(bool valid) {
+    if (!valid) {
+        throw std::invalid_argument("Key isn't a valid point.");
+    }
+}
+
+//sG.
+pybind11::bytes scalarmult_base(pybind11::bytes scalar) {
+    rct::key result;
+    backend::scalarmult_base(result, scalar_arg(scalar));
+    return key_result(result);
+}
+
+//sP.
+pybind11::bytes scalarmult_key(pybind11::bytes point, pybind11::bytes scalar) {
+    rct::key result;
+    check_point(backend::scalarmult_key(result, point_arg(point), scalar_arg(scalar)));
+    return key_result(result);
+}
+
+//P + Q.
+pybind11::bytes add_keys(pybind11::bytes p, pybind11::bytes q) {
+    rct::key result;
+    check_point(backend::add_keys(result, point_arg(p), point_arg(q), false));
+    return key_result(result);
+}
+
+//P - Q.
+pybind11::bytes sub_keys(pybind11::bytes p, pybind11::bytes q) {
+    rct::key result;
+    check_point(backend::add_keys(result, point_arg(p), point_arg(q), true));
+    return key_result(result);
+}
+
+//Keccak-256 mod l.
+pybind11::bytes hash_to_scalar(const std::string &data) {
+    crypto::ec_scalar result;
+    crypto::hash_to_scalar(data.data(), data.size(), result);
+    return pybind11::bytes(std::string(result.data, 32));
+}
+
+//Shared key of a Transaction, 8aR.
+pybind11::bytes generate_key_derivation(pybind11::bytes point, pybind11::bytes scalar) {
+    rct::key sec = scalar_arg(scalar);
+    rct::key result;
+    bool valid = backend::derivation(result, point_arg(point), sec);
+    memwipe(sec.bytes, 32);
+    check_point(valid);
+    return key_result(result);
+}
+
+//Scan Transactions, each specified by its Rs and output keys, split over threads without the GIL. 0 threads uses every core.
+//Returns each Transaction's shared keys, 8aR, and for each shared key, the spend key of each output, P - Hs(8aR || o)G.
+//Throws if an R or output key isn't a valid point, as deriving them one at a time does.
+//variable_time derives the shared keys with a faster path whose timing depends on the view key. Only use it where that isn't observable.
+typedef std::pair<std::vector<pybind11::bytes>, std::vector<std::vector<pybind11::bytes>>> ScannedTransaction;
+
+std::vector<ScannedTransaction> scan_transactions(
+    pybind11::bytes view_key_arg,
+    const std::vector<std::pair<std::vector<std::string>, std::vector<std::string>>> &txs,
+    size_t threads,
+    bool variable_time
+) {
+    rct::key view_key = scalar_arg(view_key_arg);
+
+    //Flatten the keys. Keys of the wrong length are invalid points.
+    std::vector<rct::key> Rs;
+    std::vector<rct::key> output_keys;
+    std::vector<uint8_t> Rs_sized;
+    std::vector<uint8_t> output_keys_sized;
+    for (const std::pair<std::vector<std::string>, std::vector<std::string>> &tx : txs) {
+        for (const std::string &R : tx.first) {
+            Rs.emplace_back(rct::identity());
+            Rs_sized.push_back(R.size() == 32);
+            if (Rs_sized.back()) {
+                memcpy(Rs.back().bytes, R.data(), 32);
+            }
+        }
+        for (const std::string &key : tx.second) {
+            output_keys.emplace_back(rct::identity());
+            output_keys_sized.push_back(key.size() == 32);
+            if (output_keys_sized.back()) {
+                memcpy(output_keys.back().bytes, key.data(), 32);
+            }
+        }
+    }
+
+    std::vector<rct::key> shared_keys;
+    std::vector<uint8_t> shared_valid;
+    std::vector<rct::key> spend_keys;
+    std::vector<uint8_t> spend_valid;
+    {
+        pybind11::gil_scoped_release release;
+        derivations_many(view_key, Rs, shared_keys, shared_valid, threads, variable_time);
+
+        //Every output for every valid shared key, with its amount key Hs(8aR || o).
+        std::vector<rct::key> points;
+        std::vector<rct::key> amount_keys;
+        size_t r = 0;
+        size_t o = 0;
+        for (const std::pair<std::vector<std::string>, std::vector<std::string>> &tx : txs) {
+            for (size_t tx_r = 0; tx_r < tx.first.size(); tx_r++) {
+                shared_valid[r] = shared_valid[r] && Rs_sized[r];
+                if (shared_valid[r]) {
+                    for (size_t tx_o = 0; tx_o < tx.second.size(); tx_o++) {
+                        crypto::ec_scalar amount_key;
+                        crypto::derivation_to_scalar(rct::rct2kd(shared_keys[r]), tx_o, amount_key);
+                        points.push_back(output_keys[o + tx_o]);
+                        amount_keys.emplace_back();
+                        memcpy(amount_keys.back().bytes, amount_key.data, 32);
+                    }
+                }
+                r++;
+            }
+            o += tx.second.size();
+        }
+        sub_base_many(points, amount_keys, spend_keys, spend_valid, threads);
+        memwipe(amount_keys.data(), amount_keys.size() * sizeof(rct::key));
+    }
+    memwipe(view_key.bytes, 32);
+
+    std::vector<ScannedTransaction> result;
+    result.reserve(txs.size());
+    size_t r = 0;
+    size_t o = 0;
+    size_t spend = 0;
+    for (const std::pair<std::vector<std::string>, std::vector<std::string>> &tx : txs) {
+        result.emplace_back();
+        for (size_t tx_r = 0; tx_r < tx.first.size(); tx_r++) {
+            check_point(shared_valid[r]);
+            result.back().first.push_back(key_result(shared_keys[r]));
+            result.back().second.emplace_back();
+            for (size_t tx_o = 0; tx_o < tx.second.size(); tx_o++) {
+                check_point(spend_valid[spend] && output_keys_sized[o + tx_o]);
+                result.back().second.back().push_back(key_result(spend_keys[spend]));
+                spend++;
+            }
+            r++;
+        }
+        o += tx.second.size();
+    }
+    return result;
+}
+
+//Pedersen commitment, mask G + amount H.
+pybind11::bytes commit(uint64_t amount, pybind11::bytes mask) {
+    rct::key result;
+    backend::commit(result, amount, scalar_arg(mask));
+    return key_result(result);
+}
+
+//Subaddress key pair. The spend key is B + Hs("SubAddr\0" || a || major || minor)G and the view key is a times that.
+//The root address is aG and B. Returns false if B is invalid.
+bool subaddress_key_pair(
+    const crypto::secret_key &view,
+    const rct::key &spend,
+    uint32_t major,
+    uint32_t minor,
+    rct::key &view_result,
+    rct::key &spend_result
+) {
+    if ((major == 0) && (minor == 0)) {
+        backend::scalarmult_base(view_result, rct::sk2rct(view));
+        spend_result = spend;
+        return true;
+    }
+
+    crypto::ec_scalar subaddress;
+    subaddress_secret(view, major, minor, subaddress);
+    rct::key subaddress_key;
+    memcpy(subaddress_key.bytes, subaddress.data, 32);
+    backend::scalarmult_base(subaddress_key, subaddress_key);
+    bool valid = backend::add_keys(spend_result, spend, subaddress_key, false)
+        && backend::scalarmult_key(view_result, spend_result, rct::sk2rct(view));
+    memwipe(subaddress.data, 32);
+    return valid;
+}
+
+pybind11::tuple generate_subaddress_key_pair(
+    pybind11::bytes view_key_arg,
+    pybind11::bytes spend_key_arg,
+    std::pair<uint32_t, uint32_t> index
+) {
+    crypto::secret_key view_key;
+    memcpy(view_key.data, key_bytes(view_key_arg), 32);
+    rct::key view_result;
+    rct::key spend_result;
+    bool valid = subaddress_key_pair(view_key, point_arg(spend_key_arg), index.first, index.second, view_result, spend_result);
+    memwipe(view_key.data, 32);
+    check_point(valid);
+    return pybind11::make_tuple(key_result(view_result), key_result(spend_result));
+}
+
+//Key image xHp(P) of a one-time key pair, with the multiplication on the backend. Hp(P) is always a valid point.
+void key_image(crypto::key_image &image, const rct::key &pub_key, const rct::key &priv_key) {
+    rct::key result;
+    backend::scalarmult_key(result, rct::hashToPoint(pub_key), priv_key);
+    memcpy(image.data, result.bytes, 32);
+}
+
+//Key image of a one-time private key, deriving its public key if it wasn't passed in.
 pybind11::bytes generate_key_image(
     pybind11::bytes priv_key_arg,
-    pybind11::bytes pub_key_arg
+    pybind11::object pub_key_arg
+) {
+    rct::key priv_key;
+    rct::key pub_key;
+    memcpy(priv_key.bytes, PYBIND11_BYTES_AS_STRING(priv_key_arg.ptr()), 32);
+    if (pub_key_arg.is_none()) {
+        backend::scalarmult_base(pub_key, priv_key);
+    } else {
+        memcpy(pub_key.bytes, PYBIND11_BYTES_AS_STRING(pub_key_arg.ptr()), 32);
+    }
+
+    crypto::key_image image;
+    key_image(image, pub_key, priv_key);
+    memwipe(priv_key.bytes, 32);
+    return pybind11::bytes(std::string(image.data, 32));
+}
+
+//Generate the key images for many outputs, each specified by its amount key and subaddress index.
+//The one-time keys are derived natively and the outputs are split over threads without the GIL.
+std::vector<pybind11::bytes> generate_key_images_many(
+    pybind11::bytes view_key_arg,
+    pybind11::bytes spend_key_arg,
+    std::vector<std::tuple<pybind11::bytes, std::pair<uint32_t, uint32_t>>> outputs_arg,
+    size_t threads
+) {
+    crypto::secret_key view_key;
+    crypto::secret_key spend_key;
+    memcpy(view_key.data, PYBIND11_BYTES_AS_STRING(view_key_arg.ptr()), 32);
+    memcpy(spend_key.data, PYBIND11_BYTES_AS_STRING(spend_key_arg.ptr()), 32);
+
+    std::vector<rct::key> amount_keys(outputs_arg.size());
+    std::vector<std::pair<uint32_t, uint32_t>> subaddresses(outputs_arg.size());
+    for (size_t i = 0; i < outputs_arg.size(); i++) {
+        memcpy(amount_keys[i].bytes, PYBIND11_BYTES_AS_STRING(std::get<0>(outputs_arg[i]).ptr()), 32);
+        subaddresses[i] = std::get<1>(outputs_arg[i]);
+    }
+
+    std::vector<crypto::key_image> images(outputs_arg.size());
+    {
+        pybind11::gil_scoped_release release;
+        parallel_for(outputs_arg.size(), threads, [&](size_t i) {
+            crypto::secret_key priv_key;
+            input_key(view_key, spend_key, amount_keys[i], subaddresses[i].first, subaddresses[i].second, priv_key);
+
+            rct::key pub_key;
+            backend::scalarmult_base(pub_key, rct::sk2rct(priv_key));
+            key_image(images[i], pub_key, rct::sk2rct(priv_key));
+            memwipe(priv_key.data, 32);
+        });
+    }
+    memwipe(amount_keys.data(), amount_keys.size() * sizeof(rct::key));
+
+    std::vector<pybind11::bytes> result;
+    result.reserve(images.size());
+    for (crypto::key_image &image : images) {
+        result.emplace_back(std::string(image.data, 32));
+    }
+    return result;
+}
+
+//One-time private keys and key images of many inputs, each specified by its amount key and (subaddress) private spend key.
+//Used to sign, so every input of a Transaction is handled by one call, split over threads without the GIL.
+std::vector<std::pair<pybind11::bytes, pybind11::bytes>> generate_input_keys_many(
+    const std::vector<std::pair<pybind11::bytes, pybind11::bytes>> &inputs_arg,
+    size_t threads
+) {
+    std::vector<crypto::secret_key> keys(inputs_arg.size());
+    for (size_t i = 0; i < inputs_arg.size(); i++) {
+        sc_add(
+            (unsigned char*) keys[i].data,
+            (const unsigned char*) key_bytes(inputs_arg[i].first),
+            (const unsigned char*) key_bytes(inputs_arg[i].second)
+        );
+    }
+
+    std::vector<crypto::key_image> images(keys.size());
+    {
+        pybind11::gil_scoped_release release;
+        parallel_for(keys.size(), threads, [&](size_t i) {
+            rct::key pub_key;
+            backend::scalarmult_base(pub_key, rct::sk2rct(keys[i]));
+            key_image(images[i], pub_key, rct::sk2rct(keys[i]));
+        });
+    }
+
+    std::vector<std::pair<pybind11::bytes, pybind11::bytes>> result;
+    result.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        result.emplace_back(std::string(keys[i].data, 32), std::string(images[i].data, 32));
+    }
+    memwipe(keys.data(), keys.size() * sizeof(crypto::secret_key));
+    return result;
+}
+
+//Convert a RingCT type to the config genRctSimple uses to produce it.
+rct::RCTConfig rct_config(uint8_t rct_type) {
+    switch (rct_type) {
+        case rct::RCTTypeCLSAG:
+            return {rct::RangeProofPaddedBulletproof, 3};
+        case rct::RCTTypeBulletproofPlus:
+            return {rct::RangeProofPaddedBulletproof, 4};
+        default:
+            throw std::invalid_argument("Unsupported RingCT type.");
+    }
+}
+
+//Scratch memory for a signing context's per-Transaction temporaries.
+//Buffers only grow, so once they've fit the largest Transaction seen, converting arguments doesn't allocate.
+//Rows of the ring are kept aside when a smaller ring is used, instead of being freed.
+//Monero's RingCT API takes std::vectors, so this can't cover allocations made inside genRctSimple itself.
+class SigningArena {
+    public:
+        rct::ctkeyV private_keys;
+        rct::keyV destinations;
+        rct::keyV amount_keys;
+        rct::ctkeyM ring;
+        //Output masks genRctSimple writes back (its outSk). Nothing reads them, yet they're secret, so they're wiped with the rest.
+        rct::ctkeyV out_keys;
+
+        SigningArena(): buffer_allocations(0), acquisitions(0) {}
+
+        ~SigningArena() {
+            release();
+        }
+
+        //Size the buffers for a Transaction.
+        void acquire(size_t inputs, size_t outputs) {
+            acquisitions++;
+
+            size(private_keys, inputs);
+            size(destinations, outputs);
+            size(amount_keys, outputs);
+            size(out_keys, outputs);
+
+            while (ring.size() > inputs) {
+                spare_rows.push_back(std::move(ring.back()));
+                ring.pop_back();
+            }
+            if (inputs > ring.capacity()) {
+                buffer_allocations++;
+                ring.reserve(inputs);
+            }
+            while (ring.size() < inputs) {
+                if (spare_rows.empty()) {
+                    ring.emplace_back();
+                } else {
+                    ring.push_back(std::move(spare_rows.back()));
+                    spare_rows.pop_back();
+                }
+            }
+        }
+
+        //Size a row of the ring.
+        void acquire_row(size_t i, size_t members) {
+            size(ring[i], members);
+        }
+
+        //Wipe the key material. Public data (destinations and the ring) is left as is.
+        void release() {
+            memwipe(private_keys.data(), private_keys.size() * sizeof(rct::ctkey));
+            memwipe(amount_keys.data(), amount_keys.size() * sizeof(rct::key));
+            memwipe(out_keys.data(), out_keys.size() * sizeof(rct::ctkey));
+        }
+
+        //Amount of times one of the arena's own buffers had to be allocated or grown.
+        //Allocations made by Monero's provers, and for the returned signatures, aren't counted.
+        size_t buffer_allocations;
+        //Amount of Transactions the arena was acquired for.
+        size_t acquisitions;
+
+    private:
+        std::vector<rct::ctkeyV> spare_rows;
+
+        template<typename T>
+        void size(std::vector<T> &buffer, size_t length) {
+            if (length > buffer.capacity()) {
+                buffer_allocations++;
+                buffer.reserve(length);
+            }
+            buffer.resize(length);
+        }
+};
+
+//Releases an arena when it goes out of scope, even if signing throws.
+class ArenaGuard {
+    public:
+        ArenaGuard(SigningArena &arena): arena(arena) {}
+        ~ArenaGuard() {
+            arena.release();
+        }
+
+    private:
+        SigningArena &arena;
+};
+
+//Signing context.
+//Owns the device and the arena arguments are converted into.
+//Monero's Bulletproof generators and multiexp caches are process-wide and built on first use; warm_up builds them ahead of time.
+class Signer {
+    public:
+        Signer(uint8_t rct_type):
+            device(hw::get_device("default")),
+            rct_type(rct_type),
+            config(rct_config(rct_type)),
+            plus(config.bp_version == 4),
+            warm(false) {}
+
+        //Perform the one-time precomputation by proving a throwaway range proof.
+        void warm_up() {
+            pybind11::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (warm) {
+                return;
+            }
+
+            if (plus) {
+                rct::bulletproof_plus_PROVE((uint64_t) 0, rct::skGen());
+            } else {
+                rct::bulletproof_PROVE((uint64_t) 0, rct::skGen());
+            }
+            warm = true;
+        }
+
+        bool is_warm() {
+            std::unique_lock<std::mutex> lock = lock_without_gil();
+            return warm;
+        }
+
+        uint8_t get_rct_type() {
+            return rct_type;
+        }
+
+        rct::rctSig sign(
+            pybind11::bytes prefix_hash_arg,
+            std::vector<pybind11::tuple> private_keys_arg,
+            std::vector<pybind11::bytes> destinations_arg,
+            std::vector<pybind11::bytes> amount_keys_arg,
+            std::vector<std::vector<std::vector<pybind11::bytes>>> ring_arg,
+            std::vector<unsigned int> indexes,
+            std::vector<rct::xmr_amount> inputs,
+            std::vector<rct::xmr_amount> outputs,
+            rct::xmr_amount fee
+        ) {
+            std::unique_lock<std::mutex> lock = lock_without_gil();
+
+            arena.acquire(private_keys_arg.size(), destinations_arg.size());
+            ArenaGuard guard(arena);
+
+            //Extract the private keys.
+            for (uint i = 0; i < private_keys_arg.size(); i++) {
+                memcpy(arena.private_keys[i].dest.bytes, PYBIND11_BYTES_AS_STRING(private_keys_arg[i][0].ptr()), 32);
+                memcpy(arena.private_keys[i].mask.bytes, PYBIND11_BYTES_AS_STRING(private_keys_arg[i][1].ptr()), 32);
+            }
+
+            //Extract the destination keys.
+            for (uint i = 0; i < destinations_arg.size(); i++) {
+                memcpy(arena.destinations[i].bytes, PYBIND11_BYTES_AS_STRING(destinations_arg[i].ptr()), 32);
+            }
+
+            //Extract the amount keys (Hs(8rA || i)).
+            if (amount_keys_arg.size() != destinations_arg.size()) {
+                throw std::invalid_argument("Amount of amount keys doesn't match the amount of destinations.");
+            }
+            for (uint i = 0; i < amount_keys_arg.size(); i++) {
+                memcpy(arena.amount_keys[i].bytes, PYBIND11_BYTES_AS_STRING(amount_keys_arg[i].ptr()), 32);
+            }
+
+            //Create the ring.
+            if (ring_arg.size() != private_keys_arg.size()) {
+                throw std::invalid_argument("Amount of rings doesn't match the amount of inputs.");
+            }
+            for (uint i = 0; i < ring_arg.size(); i++) {
+                arena.acquire_row(i, ring_arg[i].size());
+                for (uint v = 0; v < ring_arg[i].size(); v++) {
+                    memcpy(arena.ring[i][v].dest.bytes, PYBIND11_BYTES_AS_STRING(ring_arg[i][v][0].ptr()), 32);
+                    memcpy(arena.ring[i][v].mask.bytes, PYBIND11_BYTES_AS_STRING(ring_arg[i][v][1].ptr()), 32);
+                }
+            }
+
+            return prove(prefix_hash_arg, indexes, inputs, outputs, fee);
+        }
+
+        //Sign with the keys and ring passed as contiguous buffers (bytes, memoryview, numpy arrays...).
+        //Private keys are inputs * (key, mask), destinations and amount keys are outputs * 32 bytes, and the ring is inputs * ring size * (key, mask).
+        //Each buffer is copied into the arena with one memcpy per array (or ring row) instead of one per key.
+        rct::rctSig sign_flat(
+            pybind11::bytes prefix_hash_arg,
+            pybind11::buffer private_keys_arg,
+            pybind11::buffer destinations_arg,
+            pybind11::buffer amount_keys_arg,
+            pybind11::buffer ring_arg,
+            std::vector<unsigned int> indexes,
+            std::vector<rct::xmr_amount> inputs,
+            std::vector<rct::xmr_amount> outputs,
+            rct::xmr_amount fee
+        ) {
+            pybind11::buffer_info private_keys_info = contiguous(private_keys_arg, "private keys");
+            pybind11::buffer_info destinations_info = contiguous(destinations_arg, "destinations");
+            pybind11::buffer_info amount_keys_info = contiguous(amount_keys_arg, "amount keys");
+            pybind11::buffer_info ring_info = contiguous(ring_arg, "ring");
+
+            size_t input_count = length(private_keys_info) / sizeof(rct::ctkey);
+            size_t output_count = length(destinations_info) / sizeof(rct::key);
+            if (
+                (length(private_keys_info) != input_count * sizeof(rct::ctkey)) ||
+                (length(destinations_info) != output_count * sizeof(rct::key)) ||
+                (length(amount_keys_info) != output_count * sizeof(rct::key))
+            ) {
+                throw std::invalid_argument("Key buffers must be a multiple of 32 bytes with an amount key per destination.");
+            }
+            if ((input_count == 0) || (length(ring_info) % (input_count * sizeof(rct::ctkey)) != 0)) {
+                throw std::invalid_argument("Ring buffer must be inputs * ring size * 64 bytes.");
+            }
+            size_t ring_size = length(ring_info) / (input_count * sizeof(rct::ctkey));
+
+            std::unique_lock<std::mutex> lock = lock_without_gil();
+
+            arena.acquire(input_count, output_count);
+            ArenaGuard guard(arena);
+
+            memcpy(arena.private_keys.data(), private_keys_info.ptr, length(private_keys_info));
+            memcpy(arena.destinations.data(), destinations_info.ptr, length(destinations_info));
+            memcpy(arena.amount_keys.data(), amount_keys_info.ptr, length(amount_keys_info));
+            for (size_t i = 0; i < input_count; i++) {
+                arena.acquire_row(i, ring_size);
+                memcpy(
+                    arena.ring[i].data(),
+                    ((const uint8_t*) ring_info.ptr) + (i * ring_size * sizeof(rct::ctkey)),
+                    ring_size * sizeof(rct::ctkey)
+                );
+            }
+
+            return prove(prefix_hash_arg, indexes, inputs, outputs, fee);
+        }
+
+        size_t get_arena_allocations() {
+            std::unique_lock<std::mutex> lock = lock_without_gil();
+            return arena.buffer_allocations;
+        }
+
+        size_t get_signatures() {
+            std::unique_lock<std::mutex> lock = lock_without_gil();
+            return arena.acquisitions;
+        }
+
+    private:
+        std::mutex mutex;
+
+        //Lock without the GIL so a thread signing without the GIL can reacquire it.
+        std::unique_lock<std::mutex> lock_without_gil() {
+            std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+            pybind11::gil_scoped_release release;
+            lock.lock();
+            return lock;
+        }
+
+        //Request a C-contiguous view of a buffer.
+        static pybind11::buffer_info contiguous(pybind11::buffer &buffer, const std::string &name) {
+            pybind11::buffer_info info = buffer.request();
+            pybind11::ssize_t stride = info.itemsize;
+            for (pybind11::ssize_t d = info.ndim - 1; d >= 0; d--) {
+                if ((info.shape[d] != 1) && (info.strides[d] != stride)) {
+                    throw std::invalid_argument("The " + name + " buffer isn't contiguous.");
+                }
+                stride *= info.shape[d];
+            }
+            return info;
+        }
+
+        static size_t length(const pybind11::buffer_info &info) {
+            return info.size * info.itemsize;
+        }
+
+        //Create the RingCT Signatures from the arena. Must be called with the lock held and the arena acquired.
+        rct::rctSig prove(
+            const pybind11::bytes &prefix_hash_arg,
+            std::vector<unsigned int> &indexes,
+            std::vector<rct::xmr_amount> &inputs,
+            std::vector<rct::xmr_amount> &outputs,
+            rct::xmr_amount fee
+        ) {
+            //Extract the prefix hash.
+            crypto::hash prefix_hash;
+            memcpy(prefix_hash.data, key_bytes(prefix_hash_arg), 32);
+
+            pybind11::gil_scoped_release release;
+            rct::rctSig result = rct::genRctSimple(
+                rct::hash2rct(prefix_hash),
+                arena.private_keys,
+                arena.destinations,
+                inputs,
+                outputs,
+                fee,
+                arena.ring,
+                arena.amount_keys,
+                NULL,
+                NULL,
+                indexes,
+                arena.out_keys,
+                config,
+                device
+            );
+            warm = true;
+            return result;
+        }
+
+        hw::device &device;
+        uint8_t rct_type;
+        rct::RCTConfig config;
+        bool plus;
+        bool warm;
+
+        SigningArena arena;
+};
+
+//Sign with a Signer created for this call alone, so its arena is never reused and calls don't serialize on a shared lock.
+//Callers signing repeatedly should hold a Signer, as MoneroCrypto does.
+rct::rctSig generate_ringct_signatures(
+    pybind11::bytes prefix_hash_arg,
+    std::vector<pybind11::tuple> private_keys_arg,
+    std::vector<pybind11::bytes> destinations_arg,
+    std::vector<pybind11::bytes> amount_keys_arg,
+    std::vector<std::vector<std::vector<pybind11::bytes>>> ring_arg,
+    std::vector<unsigned int> indexes,
+    std::vector<rct::xmr_amount> inputs,
+    std::vector<rct::xmr_amount> outputs,
+    rct::xmr_amount fee,
+    uint8_t rct_type
+) {
+    return Signer(rct_type).sign(
+        prefix_hash_arg,
+        private_keys_arg,
+        destinations_arg,
+        amount_keys_arg,
+        ring_arg,
+        indexes,
+        inputs,
+        outputs,
+        fee
+    );
+}
+
+//Length of a VarInt.
+size_t var_int_length(uint64_t value) {
+    size_t length = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        length++;
+    }
+    return length;
+}
+
+//Exact weight of a Transaction created by this library, using the same formulas as cryptonote::get_transaction_weight.
+//Mixins are the sorted global indexes of each input's ring. They're serialized as relative offsets.
+uint64_t get_transaction_weight(
+    const std::vector<std::vector<uint64_t>> &mixins,
+    size_t outputs,
+    size_t extra,
+    uint64_t fee,
+    uint8_t rct_type
+) {
+    //Rejects unsupported types.
+    bool plus = rct_config(rct_type).bp_version == 4;
+    if ((outputs == 0) || (outputs > BULLETPROOF_MAX_OUTPUTS)) {
+        throw std::invalid_argument("Invalid amount of outputs.");
+    }
+
+    //Version and unlock time.
+    uint64_t size = 2;
+
+    //Inputs.
+    size += var_int_length(mixins.size());
+    for (const std::vector<uint64_t> &ring : mixins) {
+        //Tag, amount, offsets, and the key image.
+        size += 2 + var_int_length(ring.size()) + 32;
+        uint64_t last = 0;
+        for (uint64_t mixin : ring) {
+            size += var_int_length(mixin - last);
+            last = mixin;
+        }
+    }
+
+    //Outputs (amount, tag, key, and the view tag BulletproofPlus requires), and extra.
+    size += var_int_length(outputs) + ((plus ? 35 : 34) * outputs);
+    size += var_int_length(extra) + extra;
+
+    //RingCT base. Type, fee, encrypted amounts, and commitments.
+    size += 1 + var_int_length(fee) + (40 * outputs);
+
+    //Range proof. Its L and R have log2(64 * padded outputs) elements each.
+    size_t padded = 1;
+    size_t lr = 6;
+    while (padded < outputs) {
+        padded <<= 1;
+        lr++;
+    }
+    size_t proof_keys = plus ? 6 : 9;
+    size += 1 + (32 * proof_keys) + (2 * (var_int_length(lr) + (32 * lr)));
+
+    //CLSAGs (s, c1, and D) and pseudo outputs.
+    for (const std::vector<uint64_t> &ring : mixins) {
+        size += (32 * ring.size()) + 64 + 32;
+    }
+
+    //Proofs for more than two outputs are smaller than the equivalent separate proofs, so they pay back most of the difference.
+    if (padded <= 2) {
+        return size;
+    }
+    uint64_t proof_base = (32 * (proof_keys + (7 * 2))) / 2;
+    uint64_t proof_size = 32 * (proof_keys + (2 * lr));
+    return size + (((proof_base * padded) - proof_size) * 4 / 5);
+}
+
+//Parse a Transaction and fill in the RingCT fields which aren't serialized, as Monero does when it receives one.
+//The ring members are looked up by their global output index.
+bool expand_transaction(
+    const std::string &blob,
+    const std::map<uint64_t, rct::ctkey> &outputs,
+    cryptonote::transaction &tx
+) {
+    if ((!cryptonote::parse_and_validate_tx_from_blob(blob, tx)) || (tx.version != 2)) {
+        return false;
+    }
+
+    rct::rctSig &rv = tx.rct_signatures;
+    if (
+        ((rv.type != rct::RCTTypeCLSAG) && (rv.type != rct::RCTTypeBulletproofPlus)) ||
+        (rv.p.CLSAGs.size() != tx.vin.size()) ||
+        (rv.outPk.size() != tx.vout.size())
+    ) {
+        return false;
+    }
+
+    rv.message = rct::hash2rct(cryptonote::get_transaction_prefix_hash(tx));
+
+    //Rebuild the ring and key images from the inputs.
+    rv.mixRing.resize(tx.vin.size());
+    for (size_t i = 0; i < tx.vin.size(); i++) {
+        if (tx.vin[i].type() != typeid(cryptonote::txin_to_key)) {
+            return false;
+        }
+        const cryptonote::txin_to_key &input = boost::get<cryptonote::txin_to_key>(tx.vin[i]);
+
+        rv.mixRing[i].clear();
+        for (uint64_t index : cryptonote::relative_output_offsets_to_absolute(input.key_offsets)) {
+            std::map<uint64_t, rct::ctkey>::const_iterator member = outputs.find(index);
+            if (member == outputs.end()) {
+                return false;
+            }
+            rv.mixRing[i].push_back(member->second);
+        }
+        rv.p.CLSAGs[i].I = rct::ki2rct(input.k_image);
+    }
+
+    //Rebuild the output keys. Outputs may be tagged or untagged, depending on the fork the Transaction was created under.
+    for (size_t o = 0; o < tx.vout.size(); o++) {
+        crypto::public_key key;
+        if (!cryptonote::get_output_public_key(tx.vout[o], key)) {
+            return false;
+        }
+        rv.outPk[o].dest = rct::pk2rct(key);
+    }
+    return true;
+}
+
+//Verify a batch of serialized Transactions, each with a map of the ring members it uses (global index to key and commitment).
+//The semantics (range proofs and balance) are verified as one batch, so the Bulletproof multiexps are shared.
+//If the batch fails, each Transaction is checked individually to find the invalid ones.
+std::vector<bool> verify_transactions(
+    std::vector<std::pair<pybind11::bytes, std::map<uint64_t, std::pair<pybind11::bytes, pybind11::bytes>>>> transactions_arg,
+    size_t threads
+) {
+    std::vector<std::string> blobs(transactions_arg.size());
+    std::vector<std::map<uint64_t, rct::ctkey>> rings(transactions_arg.size());
+    for (size_t t = 0; t < transactions_arg.size(); t++) {
+        blobs[t] = std::string(transactions_arg[t].first);
+        for (auto &member : transactions_arg[t].second) {
+            rct::ctkey key;
+            memcpy(key.dest.bytes, PYBIND11_BYTES_AS_STRING(member.second.first.ptr()), 32);
+            memcpy(key.mask.bytes, PYBIND11_BYTES_AS_STRING(member.second.second.ptr()), 32);
+            rings[t][member.first] = key;
+        }
+    }
+
+    pybind11::gil_scoped_release release;
+
+    //Vector of bools can't be written to from multiple threads.
+    std::vector<uint8_t> valid(blobs.size(), 0);
+    std::vector<cryptonote::transaction> txs(blobs.size());
+    parallel_for(blobs.size(), threads, [&](size_t t) {
+        valid[t] = expand_transaction(blobs[t], rings[t], txs[t]);
+    });
+
+    std::vector<const rct::rctSig*> batch;
+    for (size_t t = 0; t < txs.size(); t++) {
+        if (valid[t]) {
+            batch.push_back(&txs[t].rct_signatures);
+        }
+    }
+    if ((!batch.empty()) && (!rct::verRctSemanticsSimple(batch))) {
+        parallel_for(txs.size(), threads, [&](size_t t) {
+            valid[t] = valid[t] && rct::verRctSemanticsSimple(txs[t].rct_signatures);
+        });
+    }
+
+    parallel_for(txs.size(), threads, [&](size_t t) {
+        valid[t] = valid[t] && rct::verRctNonSemanticsSimple(txs[t].rct_signatures);
+    });
+
+    return std::vector<bool>(valid.begin(), valid.end());
+}
+
+//Build the prefix of a Transaction created by this library.
+//Each input is its ring's relative offsets and its key image. Outputs are one-time keys, with their amounts hidden by RingCT.
+//View tags are only valid alongside BulletproofPlus. Without any, outputs are serialized untagged.
+void build_prefix(
+    const std::vector<std::pair<std::vector<uint64_t>, pybind11::bytes>> &inputs,
+    const std::vector<pybind11::bytes> &output_keys,
+    const std::string &view_tags,
+    const std::string &extra,
+    cryptonote::transaction &tx
+) {
+    bool tagged = !view_tags.empty();
+    if (tagged && (view_tags.size() != output_keys.size())) {
+        throw std::invalid_argument("Each output needs a view tag.");
+    }
+
+    tx.version = 2;
+    tx.unlock_time = 0;
+
+    for (const std::pair<std::vector<uint64_t>, pybind11::bytes> &input_arg : inputs) {
+        cryptonote::txin_to_key input;
+        input.amount = 0;
+        input.key_offsets = input_arg.first;
+        memcpy(&input.k_image, key_bytes(input_arg.second), 32);
+        tx.vin.push_back(input);
+    }
+
+    for (size_t o = 0; o < output_keys.size(); o++) {
+        cryptonote::tx_out output;
+        output.amount = 0;
+        if (tagged) {
+            cryptonote::txout_to_tagged_key target;
+            memcpy(&target.key, key_bytes(output_keys[o]), 32);
+            target.view_tag.data = view_tags[o];
+            output.target = target;
+        } else {
+            cryptonote::txout_to_key target;
+            memcpy(&target.key, key_bytes(output_keys[o]), 32);
+            output.target = target;
+        }
+        tx.vout.push_back(output);
+    }
+
+    tx.extra.assign(extra.begin(), extra.end());
+}
+
+//Serialize a Transaction prefix. Returns its hash, which is what the RingCT signatures sign, and its serialization.
+pybind11::tuple serialize_transaction_prefix(
+    const std::vector<std::pair<std::vector<uint64_t>, pybind11::bytes>> &inputs,
+    const std::vector<pybind11::bytes> &output_keys,
+    const std::string &view_tags,
+    const std::string &extra
+) {
+    cryptonote::transaction tx;
+    build_prefix(inputs, output_keys, view_tags, extra, tx);
+
+    std::string blob;
+    if (!cryptonote::t_serializable_object_to_blob(static_cast<cryptonote::transaction_prefix &>(tx), blob)) {
+        throw std::runtime_error("Couldn't serialize the Transaction prefix.");
+    }
+    crypto::hash hash = cryptonote::get_transaction_prefix_hash(tx);
+    return pybind11::make_tuple(pybind11::bytes(hash.data, 32), pybind11::bytes(blob));
+}
+
+//Serialize a signed Transaction. Returns its hash, H(H(prefix) || H(RingCT base) || H(prunable)), and its serialization.
+pybind11::tuple serialize_transaction(
+    const std::vector<std::pair<std::vector<uint64_t>, pybind11::bytes>> &inputs,
+    const std::vector<pybind11::bytes> &output_keys,
+    const std::string &view_tags,
+    const std::string &extra,
+    const rct::rctSig &signatures
+) {
+    if (view_tags.empty() == (signatures.type == rct::RCTTypeBulletproofPlus)) {
+        throw std::invalid_argument("Outputs are tagged if and only if the RingCT type is BulletproofPlus.");
+    }
+
+    cryptonote::transaction tx;
+    build_prefix(inputs, output_keys, view_tags, extra, tx);
+    tx.rct_signatures = signatures;
+
+    std::string blob = cryptonote::tx_to_blob(tx);
+    crypto::hash hash;
+    if (blob.empty() || (!cryptonote::get_transaction_hash(tx, hash))) {
+        throw std::runtime_error("Couldn't serialize the Transaction.");
+    }
+    return pybind11::make_tuple(pybind11::bytes(hash.data, 32), pybind11::bytes(blob));
+}
+
+//Hash serialized Transactions, split over threads without the GIL. 0 threads uses every core.
+std::vector<pybind11::bytes> get_transaction_hashes(const std::vector<std::string> &blobs, size_t threads) {
+    std::vector<crypto::hash> hashes(blobs.size());
+    //Vector of bools can't be written to from multiple threads.
+    std::vector<uint8_t> valid(blobs.size(), 0);
+    {
+        pybind11::gil_scoped_release release;
+        parallel_for(blobs.size(), threads, [&](size_t t) {
+            cryptonote::transaction tx;
+            valid[t] = cryptonote::parse_and_validate_tx_from_blob(blobs[t], tx) &&
+                cryptonote::get_transaction_hash(tx, hashes[t]);
+        });
+    }
+
+    std::vector<pybind11::bytes> result;
+    for (size_t t = 0; t < blobs.size(); t++) {
+        if (!valid[t]) {
+            throw std::invalid_argument("Transaction " + std::to_string(t) + " couldn't be parsed.");
+        }
+        result.push_back(pybind11::bytes(hashes[t].data, 32));
+    }
+    return result;
+}
+
+//Address, as its network prefix, spend key, view key, and payment ID, which is empty if there isn't one.
+typedef std::tuple<std::string, std::string, std::string, std::string> AddressParts;
+
+//Length of an address's Keccak checksum.
+#define ADDRESS_CHECKSUM_LENGTH 4
+
+//Encode an address into Base58.
+//The data is the prefix, then the keys and payment ID, then the checksum. Leading payment IDs go before the keys.
+std::string encode_address(
+    const std::string &prefix,
+    const std::string &spend_key,
+    const std::string &view_key,
+    const std::string &payment_id,
+    bool payment_id_leading
+) {
+    std::string data = prefix;
+    if (payment_id_leading) {
+        data += payment_id;
+    }
+    data += spend_key;
+    data += view_key;
+    if (!payment_id_leading) {
+        data += payment_id;
+    }
+
+    crypto::hash checksum;
+    crypto::cn_fast_hash(data.data(), data.size(), checksum);
+    data.append(checksum.data, ADDRESS_CHECKSUM_LENGTH);
+    return tools::base58::encode(data);
+}
+
+//Encode addresses into Base58, split over threads without the GIL. 0 threads uses every core.
+std::vector<std::string> encode_addresses_many(
+    const std::vector<AddressParts> &addresses,
+    bool payment_id_leading,
+    size_t threads
 ) {
-    crypto::public_key pub_key;
-    crypto::secret_key priv_key;
-    memcpy(priv_key.data, PYBIND11_BYTES_AS_STRING(priv_key_arg.ptr()), 32);
-    memcpy(pub_key.data, PYBIND11_BYTES_AS_STRING(pub_key_arg.ptr()), 32);
+    std::vector<std::string> result(addresses.size());
+    std::vector<uint8_t> valid(addresses.size(), 0);
+    {
+        pybind11::gil_scoped_release release;
+        parallel_for(addresses.size(), threads, [&](size_t a) {
+            const std::string &spend_key = std::get<1>(addresses[a]);
+            const std::string &view_key = std::get<2>(addresses[a]);
+            if ((spend_key.size() != 32) || (view_key.size() != 32)) {
+                return;
+            }
+            result[a] = encode_address(
+                std::get<0>(addresses[a]),
+                spend_key,
+                view_key,
+                std::get<3>(addresses[a]),
+                payment_id_leading
+            );
+            valid[a] = 1;
+        });
+    }
 
-    crypto::key_image image;
-    crypto::generate_key_image(pub_key, priv_key, image);
-    return pybind11::bytes(std::string(image.data, 32));
+    for (size_t a = 0; a < addresses.size(); a++) {
+        if (!valid[a]) {
+            throw std::invalid_argument("Address " + std::to_string(a) + " has an invalid key length.");
+        }
+    }
+    return result;
 }
 
-rct::rctSig generate_ringct_signatures(
-    pybind11::bytes prefix_hash_arg,
-    std::vector<pybind11::tuple> private_keys_arg,
-    std::vector<pybind11::bytes> destinations_arg,
-    std::vector<pybind11::bytes> amount_keys_arg,
-    std::vector<std::vector<std::vector<pybind11::bytes>>> ring_arg,
-    std::vector<unsigned int> indexes,
-    std::vector<rct::xmr_amount> inputs,
-    std::vector<rct::xmr_amount> outputs,
-    rct::xmr_amount fee
-) {
-    //Extract the prefix hash.
-    crypto::hash prefix_hash;
-    memcpy(prefix_hash.data, PYBIND11_BYTES_AS_STRING(prefix_hash_arg.ptr()), 32);
-
-    //Extract the private keys.
-    rct::ctkeyV private_keys(private_keys_arg.size());
-    for (uint i = 0; i < private_keys_arg.size(); i++) {
-        crypto::secret_key temp_secret;
-        memcpy(temp_secret.data, PYBIND11_BYTES_AS_STRING(private_keys_arg[i][0].ptr()), 32);
-
-        rct::ctkey temp_ct;
-        rct::key temp_key = rct::sk2rct(temp_secret);
-        temp_ct.dest = temp_key;
-        memcpy(temp_ct.mask.bytes, PYBIND11_BYTES_AS_STRING(private_keys_arg[i][1].ptr()), 32);
-        private_keys[i] = temp_ct;
-    }
-
-    //Extract the destination keys.
-    rct::keyV destinations(destinations_arg.size());
-    for (uint i = 0; i < destinations_arg.size(); i++) {
-        crypto::public_key temp_public;
-        memcpy(temp_public.data, PYBIND11_BYTES_AS_STRING(destinations_arg[i].ptr()), 32);
-        destinations[i] = rct::pk2rct(temp_public);
-    }
-
-    //Extract the amount keys (Hs(8rA || i)).
-    rct::keyV amount_keys(amount_keys_arg.size());
-    for (uint i = 0; i < amount_keys_arg.size(); i++) {
-        rct::key temp_key;
-        memcpy(temp_key.bytes, PYBIND11_BYTES_AS_STRING(amount_keys_arg[i].ptr()), 32);
-        amount_keys[i] = temp_key;
-    }
-
-    //Create the ring.
-    rct::ctkeyM ring(ring_arg.size());
-    for (uint i = 0; i < ring_arg.size(); i++) {
-        rct::ctkeyV ring_v(ring_arg[i].size());
-        for (uint v = 0; v < ring_arg[i].size(); v++) {
-            rct::ctkey temp_ct;
-            memcpy(temp_ct.dest.bytes, PYBIND11_BYTES_AS_STRING(ring_arg[i][v][0].ptr()), 32);
-            memcpy(temp_ct.mask.bytes, PYBIND11_BYTES_AS_STRING(ring_arg[i][v][1].ptr()), 32);
-            ring_v[v] = temp_ct;
-        }
-        ring[i] = ring_v;
-    }
-
-    //Create the RingCT Signatures.
-    rct::ctkeyV out_keys;
-    return rct::genRctSimple(
-        rct::hash2rct(prefix_hash),
-        private_keys,
-        destinations,
-        inputs,
-        outputs,
-        fee,
-        ring,
-        amount_keys,
-        NULL,
-        NULL,
-        indexes,
-        out_keys,
-        {rct::RangeProofPaddedBulletproof, 3},
-        hw::get_device("default")
-    );
+//Decode Base58 addresses into their parts, split over threads without the GIL. 0 threads uses every core.
+//Addresses which aren't valid Base58, are too short, or fail their checksum decode to None.
+//The network prefix and payment ID length aren't checked against the coin, which is left to the caller.
+std::vector<pybind11::object> decode_addresses_many(
+    const std::vector<std::string> &addresses,
+    size_t prefix_length,
+    bool payment_id_leading,
+    size_t threads
+) {
+    std::vector<AddressParts> decoded(addresses.size());
+    std::vector<uint8_t> valid(addresses.size(), 0);
+    {
+        pybind11::gil_scoped_release release;
+        parallel_for(addresses.size(), threads, [&](size_t a) {
+            std::string data;
+            if (
+                (!tools::base58::decode(addresses[a], data)) ||
+                (data.size() < (prefix_length + 64 + ADDRESS_CHECKSUM_LENGTH))
+            ) {
+                return;
+            }
+
+            size_t body = data.size() - ADDRESS_CHECKSUM_LENGTH;
+            crypto::hash checksum;
+            crypto::cn_fast_hash(data.data(), body, checksum);
+            if (memcmp(checksum.data, data.data() + body, ADDRESS_CHECKSUM_LENGTH) != 0) {
+                return;
+            }
+
+            size_t payment_id_length = body - (prefix_length + 64);
+            size_t keys = prefix_length + (payment_id_leading ? payment_id_length : 0);
+            size_t payment_id = payment_id_leading ? prefix_length : (prefix_length + 64);
+            decoded[a] = AddressParts(
+                data.substr(0, prefix_length),
+                data.substr(keys, 32),
+                data.substr(keys + 32, 32),
+                data.substr(payment_id, payment_id_length)
+            );
+            valid[a] = 1;
+        });
+    }
+
+    std::vector<pybind11::object> result;
+    result.reserve(addresses.size());
+    for (size_t a = 0; a < addresses.size(); a++) {
+        if (!valid[a]) {
+            result.push_back(pybind11::none());
+            continue;
+        }
+        result.push_back(pybind11::make_tuple(
+            pybind11::bytes(std::get<0>(decoded[a])),
+            pybind11::bytes(std::get<1>(decoded[a])),
+            pybind11::bytes(std::get<2>(decoded[a])),
+            pybind11::bytes(std::get<3>(decoded[a]))
+        ));
+    }
+    return result;
+}
+
+//Subaddress, as its public view key, public spend key, and Base58 address.
+typedef std::tuple<pybind11::bytes, pybind11::bytes, std::string> Subaddress;
+
+//Generate the subaddresses (major, start) to (major, start + count - 1), split over threads without the GIL. 0 threads uses every core.
+//prefixes is the standard address prefix, used by (0, 0), and the subaddress prefix.
+//The spend keys are what the scanner watches for, so a caller can fill its table from the same pass.
+std::vector<Subaddress> generate_subaddresses_many(
+    pybind11::bytes view_key_arg,
+    pybind11::bytes spend_key_arg,
+    uint32_t major,
+    uint32_t start,
+    uint32_t count,
+    std::pair<std::string, std::string> prefixes,
+    size_t threads
+) {
+    if (count > (UINT32_MAX - start)) {
+        throw std::invalid_argument("Subaddress index range overflows.");
+    }
+
+    crypto::secret_key view_key;
+    memcpy(view_key.data, key_bytes(view_key_arg), 32);
+    rct::key spend_key = point_arg(spend_key_arg);
+
+    std::vector<rct::key> view_results(count);
+    std::vector<rct::key> spend_results(count);
+    std::vector<std::string> addresses(count);
+    std::vector<uint8_t> valid(count, 0);
+    {
+        pybind11::gil_scoped_release release;
+        parallel_for(count, threads, [&](size_t i) {
+            uint32_t minor = start + i;
+            valid[i] = subaddress_key_pair(view_key, spend_key, major, minor, view_results[i], spend_results[i]);
+            if (!valid[i]) {
+                return;
+            }
+            addresses[i] = encode_address(
+                ((major == 0) && (minor == 0)) ? prefixes.first : prefixes.second,
+                std::string((const char *) spend_results[i].bytes, 32),
+                std::string((const char *) view_results[i].bytes, 32),
+                "",
+                false
+            );
+        });
+    }
+    memwipe(view_key.data, 32);
+
+    std::vector<Subaddress> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        check_point(valid[i]);
+        result.emplace_back(key_result(view_results[i]), key_result(spend_results[i]), addresses[i]);
+    }
+    return result;
+}
+
+//States of outputs, matching InputState.
+#define OUTPUT_SPENDABLE 0
+#define OUTPUT_SPENT 2
+
+//Outputs owned by a wallet, as fixed-width records in parallel arrays.
+//Hash, index, timelock, amount, spend key, subaddress, amount key, commitment, state, and whether it has Monero's fields.
+//Records are found by their hash and index through an open addressing table of record numbers plus one, kept at most half full.
+//Outputs are never removed, as wallets keep spent outputs with their state set to spent.
+class OutputStore {
+    public:
+        OutputStore(): table(16, 0) {}
+
+        size_t size() const {
+            return tx_hashes.size();
+        }
+
+        //Record of an output, or -1 if it isn't stored.
+        int64_t find(const std::string &tx_hash, uint32_t index) const {
+            if (tx_hash.size() != 32) {
+                throw std::invalid_argument("Hash isn't 32 bytes.");
+            }
+            size_t bucket = first_bucket(tx_hash.data(), index);
+            while (table[bucket] != 0) {
+                size_t record = table[bucket] - 1;
+                if ((indexes[record] == index) && (memcmp(tx_hashes[record].data, tx_hash.data(), 32) == 0)) {
+                    return record;
+                }
+                bucket = (bucket + 1) & (table.size() - 1);
+            }
+            return -1;
+        }
+
+        //Add an output, returning its record. An output which is already stored keeps its existing record.
+        size_t add(
+            const std::string &tx_hash,
+            uint32_t index,
+            uint64_t timelock,
+            uint64_t amount,
+            const std::string &spend_key,
+            std::pair<uint32_t, uint32_t> subaddress,
+            const std::string &amount_key,
+            const std::string &commitment,
+            uint8_t state,
+            bool monero
+        ) {
+            int64_t existing = find(tx_hash, index);
+            if (existing != -1) {
+                return existing;
+            }
+            if ((spend_key.size() != 32) || (amount_key.size() != 32) || (commitment.size() != 32)) {
+                throw std::invalid_argument("Key isn't 32 bytes.");
+            }
+            if (size() >= UINT32_MAX - 1) {
+                throw std::length_error("Output store is full.");
+            }
+
+            tx_hashes.emplace_back();
+            memcpy(tx_hashes.back().data, tx_hash.data(), 32);
+            indexes.push_back(index);
+            timelocks.push_back(timelock);
+            amounts.push_back(amount);
+            spend_keys.push_back(key(spend_key));
+            majors.push_back(subaddress.first);
+            minors.push_back(subaddress.second);
+            amount_keys.push_back(key(amount_key));
+            commitments.push_back(key(commitment));
+            states.push_back(state);
+            moneros.push_back(monero);
+            changed.push_back(false);
+            mark(size() - 1);
+
+            if ((size() * 2) > table.size()) {
+                rehash(table.size() * 2);
+            } else {
+                insert(size() - 1);
+            }
+            return size() - 1;
+        }
+
+        pybind11::bytes get_tx_hash(size_t record) const {
+            check(record);
+            return pybind11::bytes(tx_hashes[record].data, 32);
+        }
+
+        uint32_t get_index(size_t record) const {
+            check(record);
+            return indexes[record];
+        }
+
+        uint64_t get_timelock(size_t record) const {
+            check(record);
+            return timelocks[record];
+        }
+
+        uint64_t get_amount(size_t record) const {
+            check(record);
+            return amounts[record];
+        }
+
+        pybind11::bytes get_spend_key(size_t record) const {
+            check(record);
+            return key_result(spend_keys[record]);
+        }
+
+        std::pair<uint32_t, uint32_t> get_subaddress(size_t record) const {
+            check(record);
+            return std::make_pair(majors[record], minors[record]);
+        }
+
+        pybind11::bytes get_amount_key(size_t record) const {
+            check(record);
+            return key_result(amount_keys[record]);
+        }
+
+        pybind11::bytes get_commitment(size_t record) const {
+            check(record);
+            return key_result(commitments[record]);
+        }
+
+        uint8_t get_state(size_t record) const {
+            check(record);
+            return states[record];
+        }
+
+        //Whether the output was a MoneroOutputInfo. Other outputs are stored with those fields zeroed.
+        bool get_monero(size_t record) const {
+            check(record);
+            return moneros[record];
+        }
+
+        //Only changes to whether an output is spent are durable, so only those mark the record.
+        void set_state(size_t record, uint8_t state) {
+            check(record);
+            if ((states[record] == OUTPUT_SPENT) != (state == OUTPUT_SPENT)) {
+                mark(record);
+            }
+            states[record] = state;
+        }
+
+        //Sort keys of every output which isn't spent, sorted as InputIndex sorts them.
+        std::vector<std::tuple<uint64_t, uint64_t, pybind11::bytes, uint32_t>> index_keys() const {
+            std::vector<size_t> records;
+            for (size_t record = 0; record < size(); record++) {
+                if (states[record] != OUTPUT_SPENT) {
+                    records.push_back(record);
+                }
+            }
+            std::sort(records.begin(), records.end(), [this](size_t a, size_t b) {
+                if (amounts[a] != amounts[b]) {
+                    return amounts[a] < amounts[b];
+                }
+                if (timelocks[a] != timelocks[b]) {
+                    return timelocks[a] < timelocks[b];
+                }
+                int hashes = memcmp(tx_hashes[a].data, tx_hashes[b].data, 32);
+                if (hashes != 0) {
+                    return hashes < 0;
+                }
+                return indexes[a] < indexes[b];
+            });
+
+            std::vector<std::tuple<uint64_t, uint64_t, pybind11::bytes, uint32_t>> result;
+            result.reserve(records.size());
+            for (size_t record : records) {
+                result.emplace_back(amounts[record], timelocks[record], get_tx_hash(record), indexes[record]);
+            }
+            return result;
+        }
+
+        //Unlocked, locked, and pending totals per subaddress as of the specified height.
+        //Also returns the timelock, hash, and index of every locked output.
+        std::pair<
+            std::map<std::pair<uint32_t, uint32_t>, std::tuple<uint64_t, uint64_t, uint64_t>>,
+            std::vector<std::tuple<uint64_t, pybind11::bytes, uint32_t>>
+        > totals(uint64_t height) const {
+            std::map<std::pair<uint32_t, uint32_t>, std::tuple<uint64_t, uint64_t, uint64_t>> totals;
+            std::vector<std::tuple<uint64_t, pybind11::bytes, uint32_t>> locked;
+            for (size_t record = 0; record < size(); record++) {
+                if (states[record] == OUTPUT_SPENT) {
+                    continue;
+                }
+
+                std::tuple<uint64_t, uint64_t, uint64_t> &total = totals[std::make_pair(majors[record], minors[record])];
+                if (states[record] != OUTPUT_SPENDABLE) {
+                    std::get<2>(total) += amounts[record];
+                } else if (timelocks[record] >= height) {
+                    std::get<1>(total) += amounts[record];
+                    locked.emplace_back(timelocks[record], get_tx_hash(record), indexes[record]);
+                } else {
+                    std::get<0>(total) += amounts[record];
+                }
+            }
+            return std::make_pair(totals, locked);
+        }
+
+        //Bytes allocated for the records and the table.
+        size_t allocated() const {
+            return (tx_hashes.capacity() * sizeof(crypto::hash)) +
+                ((indexes.capacity() + majors.capacity() + minors.capacity()) * sizeof(uint32_t)) +
+                ((timelocks.capacity() + amounts.capacity()) * sizeof(uint64_t)) +
+                ((spend_keys.capacity() + amount_keys.capacity() + commitments.capacity()) * sizeof(rct::key)) +
+                states.capacity() + moneros.capacity() +
+                (table.capacity() * sizeof(uint32_t));
+        }
+
+    private:
+        std::vector<crypto::hash> tx_hashes;
+        std::vector<uint32_t> indexes;
+        std::vector<uint64_t> timelocks;
+        std::vector<uint64_t> amounts;
+        std::vector<rct::key> spend_keys;
+        std::vector<uint32_t> majors;
+        std::vector<uint32_t> minors;
+        std::vector<rct::key> amount_keys;
+        std::vector<rct::key> commitments;
+        std::vector<uint8_t> states;
+        std::vector<uint8_t> moneros;
+
+        std::vector<uint32_t> table;
+
+        //Records changed since they were last written to a WalletDB, tracked once one is attached.
+        bool tracking = false;
+        std::vector<bool> changed;
+        std::vector<uint32_t> changes;
+
+        friend class WalletDB;
+
+        void mark(size_t record) {
+            if (tracking && (!changed[record])) {
+                changed[record] = true;
+                changes.push_back(record);
+            }
+        }
+
+        static rct::key key(const std::string &bytes) {
+            rct::key result;
+            memcpy(result.bytes, bytes.data(), 32);
+            return result;
+        }
+
+        void check(size_t record) const {
+            if (record >= size()) {
+                throw std::out_of_range("Output record doesn't exist.");
+            }
+        }
+
+        //Hashes are already uniform, so their first eight bytes are mixed with the index.
+        size_t first_bucket(const char *tx_hash, uint32_t index) const {
+            uint64_t hash;
+            memcpy(&hash, tx_hash, 8);
+            hash ^= ((uint64_t) index) * 0x9E3779B97F4A7C15;
+            return hash & (table.size() - 1);
+        }
+
+        void insert(size_t record) {
+            size_t bucket = first_bucket(tx_hashes[record].data, indexes[record]);
+            while (table[bucket] != 0) {
+                bucket = (bucket + 1) & (table.size() - 1);
+            }
+            table[bucket] = record + 1;
+        }
+
+        void rehash(size_t buckets) {
+            table.assign(buckets, 0);
+            for (size_t record = 0; record < size(); record++) {
+                insert(record);
+            }
+        }
+};
+
+//Most candidates and nodes InputKeys::fit's branch and bound examines.
+#define FIT_CANDIDATES 1024
+#define FIT_NODES 100000
+
+//Sort key of an output, matching InputIndex's. Amount, unlock height, and then its hash and index as a tie breaker.
+typedef std::tuple<uint64_t, uint64_t, std::string, uint32_t> IndexKey;
+
+//Sort keys of the outputs a wallet may select, in a balanced tree so adding or removing one is logarithmic.
+//InputIndex only keeps spendable, unlocked outputs here, so selection doesn't step over outputs it can't use.
+//Keys whose timelock is at or after the passed height are still skipped, in case a height is lower than a prior one.
+class InputKeys {
+    public:
+        size_t size() const {
+            return keys.size();
+        }
+
+        //Add a key. Returns false if it was already present.
+        bool add(const IndexKey &key) {
+            check(key);
+            return keys.insert(key).second;
+        }
+
+        //Remove a key. Returns false if it wasn't present.
+        bool remove(const IndexKey &key) {
+            return keys.erase(key) != 0;
+        }
+
+        //Replace every key with already sorted keys.
+        void load(const std::vector<IndexKey> &sorted) {
+            keys.clear();
+            for (const IndexKey &key : sorted) {
+                check(key);
+                keys.emplace_hint(keys.end(), key);
+            }
+        }
+
+        std::vector<pybind11::tuple> list() const {
+            std::vector<pybind11::tuple> result;
+            result.reserve(keys.size());
+            for (const IndexKey &key : keys) {
+                result.push_back(to_python(key));
+            }
+            return result;
+        }
+
+        //Smallest key with an amount of at least amount, skipping excluded keys, or None.
+        pybind11::object ceiling(uint64_t amount, uint64_t height, const std::vector<IndexKey> &excluded) const {
+            for (auto key = keys.lower_bound(IndexKey(amount, 0, "", 0)); key != keys.end(); key++) {
+                if (usable(*key, height) && (std::find(excluded.begin(), excluded.end(), *key) == excluded.end())) {
+                    return to_python(*key);
+                }
+            }
+            return pybind11::none();
+        }
+
+        //Up to count keys with the largest amounts, of at least minimum, largest first.
+        std::vector<pybind11::tuple> largest(size_t count, uint64_t minimum, uint64_t height) const {
+            std::vector<pybind11::tuple> result;
+            for (auto key = keys.rbegin(); (key != keys.rend()) && (result.size() < count); key++) {
+                if (std::get<0>(*key) < minimum) {
+                    break;
+                }
+                if (usable(*key, height)) {
+                    result.push_back(to_python(*key));
+                }
+            }
+            return result;
+        }
+
+        //Every key with an amount less than amount, largest first.
+        std::vector<pybind11::tuple> below(uint64_t amount, uint64_t height) const {
+            std::vector<pybind11::tuple> result;
+            for (
+                auto key = std::set<IndexKey>::const_reverse_iterator(keys.lower_bound(IndexKey(amount, 0, "", 0)));
+                key != keys.rend();
+                key++
+            ) {
+                if (usable(*key, height)) {
+                    result.push_back(to_python(*key));
+                }
+            }
+            return result;
+        }
+
+        //Choose count keys whose amounts sum to at least target with the least excess, by a bounded branch and bound.
+        //Every key of such a set is at least target minus the largest count - 1 amounts, so only those are candidates, up to FIT_CANDIDATES of the largest.
+        //The search takes the largest keys first, so it finds a set whenever the candidates can cover target.
+        //It stops at an exact match or after FIT_NODES nodes. Returns an empty List if target can't be covered.
+        std::vector<pybind11::tuple> fit(size_t count, uint64_t target, uint64_t minimum, uint64_t height) const {
+            std::vector<const IndexKey*> candidates;
+            uint64_t floor = std::max(minimum, (count == 1) ? target : 0);
+            uint64_t largest = 0;
+            for (auto key = keys.rbegin(); (key != keys.rend()) && (candidates.size() < FIT_CANDIDATES); key++) {
+                if (std::get<0>(*key) < floor) {
+                    break;
+                }
+                if (!usable(*key, height)) {
+                    continue;
+                }
+
+                candidates.push_back(&*key);
+                if (candidates.size() < count) {
+                    largest += std::get<0>(*key);
+                    if ((candidates.size() == (count - 1)) && (largest < target)) {
+                        floor = std::max(minimum, target - largest);
+                    }
+                }
+            }
+            if ((count == 0) || (candidates.size() < count)) {
+                return {};
+            }
+
+            Search search;
+            search.target = target;
+            search.prefix.push_back(0);
+            for (const IndexKey *candidate : candidates) {
+                search.amounts.push_back(std::get<0>(*candidate));
+                search.prefix.push_back(search.prefix.back() + search.amounts.back());
+            }
+            search.smallest.push_back(0);
+            for (size_t r = 1; r < count; r++) {
+                search.smallest.push_back(search.smallest.back() + search.amounts[search.amounts.size() - r]);
+            }
+            search.excess = UINT64_MAX;
+            search.nodes = 0;
+            branch(search, 0, count, 0);
+
+            std::vector<pybind11::tuple> result;
+            for (size_t c : search.best) {
+                result.push_back(to_python(*candidates[c]));
+            }
+            return result;
+        }
+
+    private:
+        std::set<IndexKey> keys;
+
+        //State of a branch and bound. Amounts are sorted largest first.
+        struct Search {
+            std::vector<uint64_t> amounts;
+            //Sum of the first i amounts.
+            std::vector<uint64_t> prefix;
+            //Sum of the smallest r amounts.
+            std::vector<uint64_t> smallest;
+            uint64_t target;
+            std::vector<size_t> chosen;
+            std::vector<size_t> best;
+            uint64_t excess;
+            size_t nodes;
+        };
+
+        //Choose left more amounts from start onwards, on top of sum.
+        static void branch(Search &search, size_t start, size_t left, uint64_t sum) {
+            if (left == 0) {
+                if ((sum - search.target) < search.excess) {
+                    search.excess = sum - search.target;
+                    search.best = search.chosen;
+                }
+                return;
+            }
+
+            for (size_t i = start; (i + left) <= search.amounts.size(); i++) {
+                if ((search.excess == 0) || (search.nodes == FIT_NODES)) {
+                    return;
+                }
+                search.nodes++;
+
+                //The next left amounts are the most this branch, or any after it, can add.
+                if ((sum + (search.prefix[i + left] - search.prefix[i])) < search.target) {
+                    return;
+                }
+                //This amount and the smallest left - 1 amounts are the least it can add.
+                uint64_t least = sum + search.amounts[i] + search.smallest[left - 1];
+                if ((least >= search.target) && ((least - search.target) >= search.excess)) {
+                    continue;
+                }
+
+                search.chosen.push_back(i);
+                branch(search, i + 1, left - 1, sum + search.amounts[i]);
+                search.chosen.pop_back();
+            }
+        }
+
+        static void check(const IndexKey &key) {
+            if (std::get<2>(key).size() != 32) {
+                throw std::invalid_argument("Hash isn't 32 bytes.");
+            }
+        }
+
+        static bool usable(const IndexKey &key, uint64_t height) {
+            return std::get<1>(key) < height;
+        }
+
+        static pybind11::tuple to_python(const IndexKey &key) {
+            return pybind11::make_tuple(std::get<0>(key), std::get<1>(key), pybind11::bytes(std::get<2>(key)), std::get<3>(key));
+        }
+};
+
+//Output record as written to a WalletDB, keyed by its hash and index.
+#pragma pack(push, 1)
+struct StoredOutput {
+    uint64_t timelock;
+    uint64_t amount;
+    rct::key spend_key;
+    uint32_t major;
+    uint32_t minor;
+    rct::key amount_key;
+    rct::key commitment;
+    uint8_t state;
+    uint8_t monero;
+};
+
+//Key image record, mapping an image to its output's hash and index.
+struct StoredKeyImage {
+    crypto::hash tx_hash;
+    uint32_t index;
+};
+
+//Height and hash of the last scanned Block.
+struct StoredCheckpoint {
+    uint64_t height;
+    crypto::hash hash;
+};
+#pragma pack(pop)
+
+//Subaddress of a WalletDB. Spend key, major index, and minor index.
+typedef std::tuple<std::string, uint32_t, uint32_t> StoredSubaddress;
+//Key image of a WalletDB. Image, hash, and index.
+typedef std::tuple<std::string, std::string, uint32_t> KeyImageRecord;
+
+//State an output is written to a WalletDB with. Reserved outputs are spendable again once reloaded.
+uint8_t durable_state(uint8_t state) {
+    return state == OUTPUT_SPENT ? OUTPUT_SPENT : OUTPUT_SPENDABLE;
+}
+
+//Throw if an LMDB call failed.
+void check_mdb(int result, const char *call) {
+    if (result != MDB_SUCCESS) {
+        throw std::runtime_error(std::string(call) + " failed: " + mdb_strerror(result));
+    }
+}
+
+//Wallet state persisted in LMDB. Outputs, subaddresses, key images, and the last scanned Block.
+//Every commit is a single write transaction, so a crash loses at most the uncommitted changes.
+//Outputs are loaded straight from the memory map into an OutputStore.
+//Reservations don't outlive the process, so outputs are written as either spendable or spent.
+class WalletDB {
+    public:
+        WalletDB(const std::string &path, size_t map_size): env(nullptr) {
+            check_mdb(mdb_env_create(&env), "mdb_env_create");
+            try {
+                check_mdb(mdb_env_set_maxdbs(env, 4), "mdb_env_set_maxdbs");
+                check_mdb(mdb_env_set_mapsize(env, map_size), "mdb_env_set_mapsize");
+                check_mdb(mdb_env_open(env, path.c_str(), MDB_NOSUBDIR, 0644), "mdb_env_open");
+
+                MDB_txn *txn;
+                check_mdb(mdb_txn_begin(env, nullptr, 0, &txn), "mdb_txn_begin");
+                try {
+                    check_mdb(mdb_dbi_open(txn, "outputs", MDB_CREATE, &outputs), "mdb_dbi_open");
+                    check_mdb(mdb_dbi_open(txn, "subaddresses", MDB_CREATE, &subaddresses), "mdb_dbi_open");
+                    check_mdb(mdb_dbi_open(txn, "key_images", MDB_CREATE, &key_images), "mdb_dbi_open");
+                    check_mdb(mdb_dbi_open(txn, "checkpoint", MDB_CREATE, &checkpoints), "mdb_dbi_open");
+                } catch (...) {
+                    mdb_txn_abort(txn);
+                    throw;
+                }
+                check_mdb(mdb_txn_commit(txn), "mdb_txn_commit");
+            } catch (...) {
+                mdb_env_close(env);
+                throw;
+            }
+        }
+
+        WalletDB(const WalletDB&) = delete;
+        WalletDB& operator=(const WalletDB&) = delete;
+
+        ~WalletDB() {
+            mdb_env_close(env);
+        }
+
+        //Height and hash of the last scanned Block, or None if no Block was.
+        pybind11::object checkpoint() {
+            ReadTxn txn(env);
+            MDB_val key = checkpoint_key();
+            MDB_val value;
+            int result = mdb_get(txn.txn, checkpoints, &key, &value);
+            if (result == MDB_NOTFOUND) {
+                return pybind11::none();
+            }
+            check_mdb(result, "mdb_get");
+            if (value.mv_size != sizeof(StoredCheckpoint)) {
+                throw std::runtime_error("Checkpoint record is malformed.");
+            }
+
+            StoredCheckpoint checkpoint;
+            memcpy(&checkpoint, value.mv_data, sizeof(StoredCheckpoint));
+            return pybind11::make_tuple(checkpoint.height, pybind11::bytes(checkpoint.hash.data, 32));
+        }
+
+        //Add every stored output to an empty OutputStore and start tracking its changes.
+        size_t load(OutputStore &store) {
+            if (store.size() != 0) {
+                throw std::invalid_argument("Output store isn't empty.");
+            }
+
+            ReadTxn txn(env);
+            MDB_cursor *cursor;
+            check_mdb(mdb_cursor_open(txn.txn, outputs, &cursor), "mdb_cursor_open");
+            try {
+                MDB_val key, value;
+                int status = mdb_cursor_get(cursor, &key, &value, MDB_FIRST);
+                while (status == MDB_SUCCESS) {
+                    if ((key.mv_size != 36) || (value.mv_size != sizeof(StoredOutput))) {
+                        throw std::runtime_error("Output record is malformed.");
+                    }
+
+                    StoredOutput output;
+                    memcpy(&output, value.mv_data, sizeof(StoredOutput));
+                    uint32_t index;
+                    memcpy(&index, ((const char*) key.mv_data) + 32, 4);
+                    store.add(
+                        std::string((const char*) key.mv_data, 32),
+                        index,
+                        output.timelock,
+                        output.amount,
+                        std::string((const char*) output.spend_key.bytes, 32),
+                        std::make_pair(output.major, output.minor),
+                        std::string((const char*) output.amount_key.bytes, 32),
+                        std::string((const char*) output.commitment.bytes, 32),
+                        durable_state(output.state),
+                        output.monero
+                    );
+
+                    status = mdb_cursor_get(cursor, &key, &value, MDB_NEXT);
+                }
+                if (status != MDB_NOTFOUND) {
+                    check_mdb(status, "mdb_cursor_get");
+                }
+            } catch (...) {
+                mdb_cursor_close(cursor);
+                throw;
+            }
+            mdb_cursor_close(cursor);
+
+            store.tracking = true;
+            return store.size();
+        }
+
+        //Every stored subaddress, as its spend key, major index, and minor index.
+        std::vector<std::tuple<pybind11::bytes, uint32_t, uint32_t>> get_subaddresses() {
+            std::vector<std::tuple<pybind11::bytes, uint32_t, uint32_t>> result;
+            ReadTxn txn(env);
+            MDB_cursor *cursor;
+            check_mdb(mdb_cursor_open(txn.txn, subaddresses, &cursor), "mdb_cursor_open");
+            try {
+                MDB_val key, value;
+                int status = mdb_cursor_get(cursor, &key, &value, MDB_FIRST);
+                while (status == MDB_SUCCESS) {
+                    if (value.mv_size != 8) {
+                        throw std::runtime_error("Subaddress record is malformed.");
+                    }
+
+                    uint32_t index[2];
+                    memcpy(index, value.mv_data, 8);
+                    result.emplace_back(pybind11::bytes((const char*) key.mv_data, key.mv_size), index[0], index[1]);
+                    status = mdb_cursor_get(cursor, &key, &value, MDB_NEXT);
+                }
+                if (status != MDB_NOTFOUND) {
+                    check_mdb(status, "mdb_cursor_get");
+                }
+            } catch (...) {
+                mdb_cursor_close(cursor);
+                throw;
+            }
+            mdb_cursor_close(cursor);
+            return result;
+        }
+
+        //Hash and index of the output a key image spends, or None if the image isn't stored.
+        pybind11::object get_key_image(const std::string &image) {
+            if (image.size() != 32) {
+                throw std::invalid_argument("Key image isn't 32 bytes.");
+            }
+
+            ReadTxn txn(env);
+            MDB_val key{32, (void*) image.data()};
+            MDB_val value;
+            int result = mdb_get(txn.txn, key_images, &key, &value);
+            if (result == MDB_NOTFOUND) {
+                return pybind11::none();
+            }
+            check_mdb(result, "mdb_get");
+            if (value.mv_size != sizeof(StoredKeyImage)) {
+                throw std::runtime_error("Key image record is malformed.");
+            }
+
+            StoredKeyImage stored;
+            memcpy(&stored, value.mv_data, sizeof(StoredKeyImage));
+            return pybind11::make_tuple(pybind11::bytes(stored.tx_hash.data, 32), stored.index);
+        }
+
+        //Write the changed outputs, new subaddresses, new key images, and optionally a checkpoint in one transaction.
+        //The first commit for an OutputStore which wasn't loaded from this database writes every output.
+        //The store must not be modified until this returns.
+        void commit(
+            OutputStore &store,
+            const std::vector<StoredSubaddress> &new_subaddresses,
+            const std::vector<KeyImageRecord> &new_key_images,
+            pybind11::object checkpoint_arg
+        ) {
+            if (!store.tracking) {
+                store.tracking = true;
+                for (size_t record = 0; record < store.size(); record++) {
+                    store.mark(record);
+                }
+            }
+
+            for (const KeyImageRecord &image : new_key_images) {
+                if ((std::get<0>(image).size() != 32) || (std::get<1>(image).size() != 32)) {
+                    throw std::invalid_argument("Key image or hash isn't 32 bytes.");
+                }
+            }
+
+            bool has_checkpoint = !checkpoint_arg.is_none();
+            StoredCheckpoint checkpoint;
+            if (has_checkpoint) {
+                std::pair<uint64_t, std::string> parsed = checkpoint_arg.cast<std::pair<uint64_t, std::string>>();
+                if (parsed.second.size() != 32) {
+                    throw std::invalid_argument("Block hash isn't 32 bytes.");
+                }
+                checkpoint.height = parsed.first;
+                memcpy(checkpoint.hash.data, parsed.second.data(), 32);
+            }
+
+            if (store.changes.empty() && new_subaddresses.empty() && new_key_images.empty() && (!has_checkpoint)) {
+                return;
+            }
+
+            {
+                pybind11::gil_scoped_release release;
+
+                MDB_txn *txn;
+                check_mdb(mdb_txn_begin(env, nullptr, 0, &txn), "mdb_txn_begin");
+                try {
+                    for (uint32_t record : store.changes) {
+                        char key_bytes[36];
+                        memcpy(key_bytes, store.tx_hashes[record].data, 32);
+                        memcpy(key_bytes + 32, &store.indexes[record], 4);
+                        StoredOutput output{
+                            store.timelocks[record],
+                            store.amounts[record],
+                            store.spend_keys[record],
+                            store.majors[record],
+                            store.minors[record],
+                            store.amount_keys[record],
+                            store.commitments[record],
+                            durable_state(store.states[record]),
+                            store.moneros[record]
+                        };
+                        put(txn, outputs, key_bytes, 36, &output, sizeof(StoredOutput));
+                    }
+
+                    for (const StoredSubaddress &subaddress : new_subaddresses) {
+                        uint32_t index[2] = {std::get<1>(subaddress), std::get<2>(subaddress)};
+                        put(txn, subaddresses, std::get<0>(subaddress).data(), std::get<0>(subaddress).size(), index, 8);
+                    }
+
+                    for (const KeyImageRecord &image : new_key_images) {
+                        StoredKeyImage stored;
+                        memcpy(stored.tx_hash.data, std::get<1>(image).data(), 32);
+                        stored.index = std::get<2>(image);
+                        put(txn, key_images, std::get<0>(image).data(), 32, &stored, sizeof(StoredKeyImage));
+                    }
+
+                    if (has_checkpoint) {
+                        MDB_val key = checkpoint_key();
+                        put(txn, checkpoints, key.mv_data, key.mv_size, &checkpoint, sizeof(StoredCheckpoint));
+                    }
+                } catch (...) {
+                    mdb_txn_abort(txn);
+                    throw;
+                }
+                check_mdb(mdb_txn_commit(txn), "mdb_txn_commit");
+            }
+
+            for (uint32_t record : store.changes) {
+                store.changed[record] = false;
+            }
+            store.changes.clear();
+        }
+
+    private:
+        MDB_env *env;
+        MDB_dbi outputs;
+        MDB_dbi subaddresses;
+        MDB_dbi key_images;
+        MDB_dbi checkpoints;
+
+        //Read-only transaction, aborted when it goes out of scope.
+        struct ReadTxn {
+            MDB_txn *txn;
+
+            explicit ReadTxn(MDB_env *env) {
+                check_mdb(mdb_txn_begin(env, nullptr, MDB_RDONLY, &txn), "mdb_txn_begin");
+            }
+
+            ~ReadTxn() {
+                mdb_txn_abort(txn);
+            }
+        };
+
+        static MDB_val checkpoint_key() {
+            static const char key[] = "scanned";
+            return MDB_val{sizeof(key) - 1, (void*) key};
+        }
+
+        static void put(MDB_txn *txn, MDB_dbi dbi, const void *key_data, size_t key_size, const void *value_data, size_t value_size) {
+            MDB_val key{key_size, (void*) key_data};
+            MDB_val value{value_size, (void*) value_data};
+            check_mdb(mdb_put(txn, dbi, &key, &value, 0), "mdb_put");
+        }
+};
+
+//Version of the binary cold-signing context.
+#define CONTEXT_VERSION 1
+
+//Input of a cold-signing context.
+//Hash, index, timelock, amount, spend key, subaddress, amount key, commitment, state, and index in its ring.
+typedef std::tuple<
+    std::string,
+    uint64_t,
+    uint64_t,
+    uint64_t,
+    std::string,
+    std::pair<uint32_t, uint32_t>,
+    std::string,
+    std::string,
+    uint8_t,
+    uint64_t
+> ContextInput;
+
+//Append a 32-byte key to a context.
+void write_key(std::string &out, const std::string &key) {
+    if (key.size() != 32) {
+        throw std::invalid_argument("Context key isn't 32 bytes.");
+    }
+    out += key;
+}
+
+//Encode a cold-signing context.
+//Layout: version, fee, inputs (each followed by its ring as relative offsets, keys, and commitments), and outputs (address and amount).
+//Every count and integer is a VarInt and every string is length prefixed.
+pybind11::bytes encode_context(
+    uint64_t fee,
+    const std::vector<ContextInput> &inputs,
+    const std::vector<std::vector<uint64_t>> &mixins,
+    const std::vector<std::vector<std::vector<std::string>>> &ring,
+    const std::vector<std::pair<std::string, uint64_t>> &outputs
+) {
+    if ((mixins.size() != inputs.size()) || (ring.size() != inputs.size())) {
+        throw std::invalid_argument("Mixins and a ring weren't provided for every input.");
+    }
+
+    std::string result(1, (char) CONTEXT_VERSION);
+    std::back_insert_iterator<std::string> out(result);
+    tools::write_varint(out, fee);
+
+    tools::write_varint(out, inputs.size());
+    for (size_t i = 0; i < inputs.size(); i++) {
+        write_key(result, std::get<0>(inputs[i]));
+        tools::write_varint(out, std::get<1>(inputs[i]));
+        tools::write_varint(out, std::get<2>(inputs[i]));
+        tools::write_varint(out, std::get<3>(inputs[i]));
+        write_key(result, std::get<4>(inputs[i]));
+        tools::write_varint(out, std::get<5>(inputs[i]).first);
+        tools::write_varint(out, std::get<5>(inputs[i]).second);
+        write_key(result, std::get<6>(inputs[i]));
+        write_key(result, std::get<7>(inputs[i]));
+        tools::write_varint(out, std::get<8>(inputs[i]));
+        tools::write_varint(out, std::get<9>(inputs[i]));
+
+        if (mixins[i].size() != ring[i].size()) {
+            throw std::invalid_argument("Ring doesn't match its mixins.");
+        }
+        tools::write_varint(out, mixins[i].size());
+        uint64_t last = 0;
+        for (size_t m = 0; m < mixins[i].size(); m++) {
+            if ((m != 0) && (mixins[i][m] <= last)) {
+                throw std::invalid_argument("Mixins aren't sorted.");
+            }
+            tools::write_varint(out, mixins[i][m] - last);
+            last = mixins[i][m];
+            if (ring[i][m].size() != 2) {
+                throw std::invalid_argument("Ring member isn't a key and commitment.");
+            }
+            write_key(result, ring[i][m][0]);
+            write_key(result, ring[i][m][1]);
+        }
+    }
+
+    tools::write_varint(out, outputs.size());
+    for (const std::pair<std::string, uint64_t> &output : outputs) {
+        tools::write_varint(out, output.first.size());
+        result += output.first;
+        tools::write_varint(out, output.second);
+    }
+
+    return pybind11::bytes(result);
+}
+
+//Bounds checked reader over a binary context.
+class ContextReader {
+    public:
+        ContextReader(const uint8_t *data, size_t size) : cursor(data), end(data + size) {}
+
+        uint64_t var_int() {
+            uint64_t result;
+            if (tools::read_varint(cursor, end, result) <= 0) {
+                throw std::invalid_argument("Context has an invalid VarInt.");
+            }
+            return result;
+        }
+
+        const char *take(size_t size) {
+            if ((size_t) (end - cursor) < size) {
+                throw std::invalid_argument("Context is truncated.");
+            }
+            const char *result = (const char *) cursor;
+            cursor += size;
+            return result;
+        }
+
+        pybind11::bytes key() {
+            return pybind11::bytes(take(32), 32);
+        }
+
+        bool done() {
+            return cursor == end;
+        }
+
+    private:
+        const uint8_t *cursor;
+        const uint8_t *end;
+};
+
+//Decode a cold-signing context, reading directly from the passed buffer.
+//Returns the fee, inputs, mixins, ring, and outputs in the forms encode_context accepts.
+pybind11::tuple decode_context(pybind11::buffer data_arg) {
+    pybind11::buffer_info data = data_arg.request();
+    if ((data.ndim != 1) || (data.itemsize != 1) || (data.strides[0] != 1)) {
+        throw std::invalid_argument("Context buffer isn't contiguous bytes.");
+    }
+
+    ContextReader reader((const uint8_t *) data.ptr, data.size);
+    if (*reader.take(1) != CONTEXT_VERSION) {
+        throw std::invalid_argument("Unknown context version.");
+    }
+    uint64_t fee = reader.var_int();
+
+    pybind11::list inputs;
+    pybind11::list mixins;
+    pybind11::list ring;
+    uint64_t input_count = reader.var_int();
+    for (uint64_t i = 0; i < input_count; i++) {
+        pybind11::bytes hash = reader.key();
+        uint64_t index = reader.var_int();
+        uint64_t timelock = reader.var_int();
+        uint64_t amount = reader.var_int();
+        pybind11::bytes spend_key = reader.key();
+        uint64_t major = reader.var_int();
+        uint64_t minor = reader.var_int();
+        pybind11::bytes amount_key = reader.key();
+        pybind11::bytes commitment = reader.key();
+        uint64_t state = reader.var_int();
+        uint64_t mixin_index = reader.var_int();
+        inputs.append(pybind11::make_tuple(
+            hash,
+            index,
+            timelock,
+            amount,
+            spend_key,
+            pybind11::make_tuple(major, minor),
+            amount_key,
+            commitment,
+            state,
+            mixin_index
+        ));
+
+        pybind11::list input_mixins;
+        pybind11::list input_ring;
+        uint64_t ring_size = reader.var_int();
+        uint64_t last = 0;
+        for (uint64_t m = 0; m < ring_size; m++) {
+            last += reader.var_int();
+            input_mixins.append(last);
+            pybind11::list member;
+            member.append(reader.key());
+            member.append(reader.key());
+            input_ring.append(member);
+        }
+        mixins.append(input_mixins);
+        ring.append(input_ring);
+    }
+
+    pybind11::list outputs;
+    uint64_t output_count = reader.var_int();
+    for (uint64_t o = 0; o < output_count; o++) {
+        uint64_t length = reader.var_int();
+        pybind11::str address(reader.take(length), length);
+        outputs.append(pybind11::make_tuple(address, reader.var_int()));
+    }
+
+    if (!reader.done()) {
+        throw std::invalid_argument("Context has trailing data.");
+    }
+    return pybind11::make_tuple(fee, inputs, mixins, ring, outputs);
 }
 
 PYBIND11_MODULE(c_monero_rct, module) {
     module.doc() = "Python Wrapper for Monero's RingCT library.";
 
     pybind11::class_<rct::key>(module, "Key")
-        .def("__getitem__", pybind11::overload_cast<int>(&rct::key::operator[]));
+        .def("__getitem__", pybind11::overload_cast<int>(&rct::key::operator[]))
+        .def("__bytes__", [](const rct::key &key) {
+            return pybind11::bytes(std::string((const char*) key.bytes, 32));
+        });
 
     pybind11::class_<rct::ctkey>(module, "CTKey")
         .def_readonly("dest", &rct::ctkey::dest)
@@ -135,6 +2483,20 @@ PYBIND11_MODULE(c_monero_rct, module) {
         .def_readonly("b", &rct::Bulletproof::b)
         .def_readonly("t", &rct::Bulletproof::t);
 
+    pybind11::class_<rct::BulletproofPlus>(module, "BulletproofPlus")
+        .def_readonly("v", &rct::BulletproofPlus::V)
+
+        .def_readonly("capital_a", &rct::BulletproofPlus::A)
+        .def_readonly("capital_a1", &rct::BulletproofPlus::A1)
+        .def_readonly("capital_b", &rct::BulletproofPlus::B)
+
+        .def_readonly("r1", &rct::BulletproofPlus::r1)
+        .def_readonly("s1", &rct::BulletproofPlus::s1)
+        .def_readonly("d1", &rct::BulletproofPlus::d1)
+
+        .def_readonly("l", &rct::BulletproofPlus::L)
+        .def_readonly("r", &rct::BulletproofPlus::R);
+
     pybind11::class_<rct::clsag>(module, "CLSAG")
         .def_readonly("s", &rct::clsag::s)
         .def_readonly("c1", &rct::clsag::c1)
@@ -143,14 +2505,319 @@ PYBIND11_MODULE(c_monero_rct, module) {
     pybind11::class_<rct::rctSigPrunable>(module, "RingCTPrunable")
         .def_readonly("pseudo_outs", &rct::rctSigPrunable::pseudoOuts)
         .def_readonly("bulletproofs", &rct::rctSigPrunable::bulletproofs)
+        .def_readonly("bulletproofs_plus", &rct::rctSigPrunable::bulletproofs_plus)
         .def_readonly("CLSAGs", &rct::rctSigPrunable::CLSAGs);
 
     pybind11::class_<rct::rctSig>(module, "RingCTSignatures")
+        .def_readonly("type", &rct::rctSig::type)
         .def_readonly("ecdh_info", &rct::rctSig::ecdhInfo)
         .def_readonly("out_public_keys", &rct::rctSig::outPk)
 
         .def_readonly("prunable", &rct::rctSig::p);
 
-    module.def("generate_key_image", &generate_key_image, "Generate a key image for a one-time key.");
-    module.def("generate_ringct_signatures", &generate_ringct_signatures, "Generate RingCT Signatures for the given data.");
+    module.def(
+        "generate_key_image",
+        &generate_key_image,
+        "Generate a key image for a one-time key. The public key is derived if it isn't passed in.",
+        pybind11::arg("priv_key"),
+        pybind11::arg("pub_key") = pybind11::none()
+    );
+    module.def(
+        "generate_subaddress_private_spend_key",
+        &generate_subaddress_private_spend_key,
+        "Generate the private spend key for a subaddress."
+    );
+    module.def(
+        "generate_input_key",
+        &generate_input_key,
+        "Generate the one-time private key of an output from its amount key and private spend key."
+    );
+    module.def(
+        "generate_subaddress_key_pair",
+        &generate_subaddress_key_pair,
+        "Generate the public view key and public spend key of a subaddress.",
+        pybind11::arg("view_key"),
+        pybind11::arg("spend_key"),
+        pybind11::arg("index")
+    );
+    module.def(
+        "generate_key_images_many",
+        &generate_key_images_many,
+        "Generate the key images for many (amount key, subaddress index) outputs in parallel. 0 threads uses every core.",
+        pybind11::arg("view_key"),
+        pybind11::arg("spend_key"),
+        pybind11::arg("outputs"),
+        pybind11::arg("threads") = 0
+    );
+    module.def(
+        "generate_input_keys_many",
+        &generate_input_keys_many,
+        "Generate the one-time private keys and key images for many (amount key, private spend key) inputs in parallel. 0 threads uses every core.",
+        pybind11::arg("inputs"),
+        pybind11::arg("threads") = 0
+    );
+    pybind11::class_<OutputStore>(module, "OutputStore")
+        .def(pybind11::init<>())
+        .def("__len__", &OutputStore::size)
+        .def("find", &OutputStore::find, "Record of an output, or -1 if it isn't stored.", pybind11::arg("tx_hash"), pybind11::arg("index"))
+        .def(
+            "add",
+            &OutputStore::add,
+            "Add an output, returning its record. An output which is already stored keeps its existing record.",
+            pybind11::arg("tx_hash"),
+            pybind11::arg("index"),
+            pybind11::arg("timelock"),
+            pybind11::arg("amount"),
+            pybind11::arg("spend_key"),
+            pybind11::arg("subaddress"),
+            pybind11::arg("amount_key"),
+            pybind11::arg("commitment"),
+            pybind11::arg("state"),
+            pybind11::arg("monero")
+        )
+        .def("tx_hash", &OutputStore::get_tx_hash, pybind11::arg("record"))
+        .def("index", &OutputStore::get_index, pybind11::arg("record"))
+        .def("timelock", &OutputStore::get_timelock, pybind11::arg("record"))
+        .def("amount", &OutputStore::get_amount, pybind11::arg("record"))
+        .def("spend_key", &OutputStore::get_spend_key, pybind11::arg("record"))
+        .def("subaddress", &OutputStore::get_subaddress, pybind11::arg("record"))
+        .def("amount_key", &OutputStore::get_amount_key, pybind11::arg("record"))
+        .def("commitment", &OutputStore::get_commitment, pybind11::arg("record"))
+        .def("state", &OutputStore::get_state, pybind11::arg("record"))
+        .def("monero", &OutputStore::get_monero, "Whether the output was a MoneroOutputInfo.", pybind11::arg("record"))
+        .def("set_state", &OutputStore::set_state, pybind11::arg("record"), pybind11::arg("state"))
+        .def("index_keys", &OutputStore::index_keys, "Sort keys of every output which isn't spent, sorted as InputIndex sorts them.")
+        .def("totals", &OutputStore::totals, "Unlocked, locked, and pending totals per subaddress, along with every locked output.", pybind11::arg("height"))
+        .def_property_readonly("allocated", &OutputStore::allocated, "Bytes allocated for the records and the table.");
+
+    pybind11::class_<InputKeys>(module, "InputKeys")
+        .def(pybind11::init<>())
+        .def("__len__", &InputKeys::size)
+        .def("add", &InputKeys::add, "Add a key. Returns false if it was already present.", pybind11::arg("key"))
+        .def("remove", &InputKeys::remove, "Remove a key. Returns false if it wasn't present.", pybind11::arg("key"))
+        .def("load", &InputKeys::load, "Replace every key with already sorted keys.", pybind11::arg("keys"))
+        .def("list", &InputKeys::list, "Every key, sorted.")
+        .def(
+            "ceiling",
+            &InputKeys::ceiling,
+            "Smallest key with an amount of at least amount, skipping excluded keys, or None.",
+            pybind11::arg("amount"),
+            pybind11::arg("height"),
+            pybind11::arg("excluded")
+        )
+        .def(
+            "largest",
+            &InputKeys::largest,
+            "Up to count keys with the largest amounts, of at least minimum, largest first.",
+            pybind11::arg("count"),
+            pybind11::arg("minimum"),
+            pybind11::arg("height")
+        )
+        .def("below", &InputKeys::below, "Every key with an amount less than amount, largest first.", pybind11::arg("amount"), pybind11::arg("height"))
+        .def(
+            "fit",
+            &InputKeys::fit,
+            "Choose count keys whose amounts sum to at least target with the least excess, by a bounded branch and bound.",
+            pybind11::arg("count"),
+            pybind11::arg("target"),
+            pybind11::arg("minimum"),
+            pybind11::arg("height")
+        );
+
+    pybind11::class_<WalletDB>(module, "WalletDB")
+        .def(pybind11::init<const std::string&, size_t>(), pybind11::arg("path"), pybind11::arg("map_size") = ((size_t) 1) << 32)
+        .def("checkpoint", &WalletDB::checkpoint, "Height and hash of the last scanned Block, or None if no Block was.")
+        .def("load", &WalletDB::load, "Add every stored output to an empty OutputStore and start tracking its changes.", pybind11::arg("store"))
+        .def("subaddresses", &WalletDB::get_subaddresses)
+        .def("key_image", &WalletDB::get_key_image, "Hash and index of the output a key image spends, or None if the image isn't stored.", pybind11::arg("image"))
+        .def(
+            "commit",
+            &WalletDB::commit,
+            "Write the changed outputs, new subaddresses, new key images, and optionally a checkpoint in one transaction.",
+            pybind11::arg("store"),
+            pybind11::arg("subaddresses"),
+            pybind11::arg("key_images"),
+            pybind11::arg("checkpoint") = pybind11::none()
+        );
+
+    pybind11::class_<Signer>(module, "Signer")
+        .def(pybind11::init<uint8_t>(), pybind11::arg("rct_type") = (uint8_t) rct::RCTTypeCLSAG)
+        .def("warm_up", &Signer::warm_up, "Build Monero's Bulletproof generators and multiexp caches ahead of the first signature.")
+        .def_property_readonly("warm", &Signer::is_warm)
+        .def_property_readonly("rct_type", &Signer::get_rct_type)
+        .def_property_readonly(
+            "arena_allocations",
+            &Signer::get_arena_allocations,
+            "Amount of times the signing arena grew one of its buffers. Allocations made inside Monero's provers aren't counted."
+        )
+        .def_property_readonly("signatures", &Signer::get_signatures, "Amount of Transactions signed.")
+        .def(
+            "sign",
+            &Signer::sign,
+            "Generate RingCT Signatures for the given data.",
+            pybind11::arg("prefix_hash"),
+            pybind11::arg("private_keys"),
+            pybind11::arg("destinations"),
+            pybind11::arg("amount_keys"),
+            pybind11::arg("ring"),
+            pybind11::arg("indexes"),
+            pybind11::arg("inputs"),
+            pybind11::arg("outputs"),
+            pybind11::arg("fee")
+        )
+        .def(
+            "sign",
+            &Signer::sign_flat,
+            "Generate RingCT Signatures with the keys and ring passed as contiguous buffers.",
+            pybind11::arg("prefix_hash"),
+            pybind11::arg("private_keys"),
+            pybind11::arg("destinations"),
+            pybind11::arg("amount_keys"),
+            pybind11::arg("ring"),
+            pybind11::arg("indexes"),
+            pybind11::arg("inputs"),
+            pybind11::arg("outputs"),
+            pybind11::arg("fee")
+        );
+
+    module.def(
+        "generate_ringct_signatures",
+        &generate_ringct_signatures,
+        "Generate RingCT Signatures for the given data with a one-off Signer. The RingCT type is either CLSAG (5) or Bulletproof+ (6).",
+        pybind11::arg("prefix_hash"),
+        pybind11::arg("private_keys"),
+        pybind11::arg("destinations"),
+        pybind11::arg("amount_keys"),
+        pybind11::arg("ring"),
+        pybind11::arg("indexes"),
+        pybind11::arg("inputs"),
+        pybind11::arg("outputs"),
+        pybind11::arg("fee"),
+        pybind11::arg("rct_type") = (uint8_t) rct::RCTTypeCLSAG
+    );
+
+    module.def(
+        "verify_transactions",
+        &verify_transactions,
+        "Verify the RingCT signatures of serialized Transactions, batching their range proofs. 0 threads uses every core.",
+        pybind11::arg("transactions"),
+        pybind11::arg("threads") = 0
+    );
+
+    module.def(
+        "serialize_transaction_prefix",
+        &serialize_transaction_prefix,
+        "Serialize a Transaction prefix, returning its hash and serialization.",
+        pybind11::arg("inputs"),
+        pybind11::arg("output_keys"),
+        pybind11::arg("view_tags"),
+        pybind11::arg("extra")
+    );
+    module.def(
+        "serialize_transaction",
+        &serialize_transaction,
+        "Serialize a signed Transaction, returning its hash and serialization.",
+        pybind11::arg("inputs"),
+        pybind11::arg("output_keys"),
+        pybind11::arg("view_tags"),
+        pybind11::arg("extra"),
+        pybind11::arg("signatures")
+    );
+    module.def(
+        "get_transaction_hashes",
+        &get_transaction_hashes,
+        "Hash serialized Transactions. 0 threads uses every core.",
+        pybind11::arg("transactions"),
+        pybind11::arg("threads") = 0
+    );
+
+    module.def(
+        "encode_addresses_many",
+        &encode_addresses_many,
+        "Encode addresses, each specified by its network prefix, spend key, view key, and payment ID, into Base58. 0 threads uses every core.",
+        pybind11::arg("addresses"),
+        pybind11::arg("payment_id_leading"),
+        pybind11::arg("threads") = 0
+    );
+    module.def(
+        "decode_addresses_many",
+        &decode_addresses_many,
+        "Decode Base58 addresses into their network prefix, spend key, view key, and payment ID, or None if invalid. 0 threads uses every core.",
+        pybind11::arg("addresses"),
+        pybind11::arg("prefix_length"),
+        pybind11::arg("payment_id_leading"),
+        pybind11::arg("threads") = 0
+    );
+
+    module.def(
+        "generate_subaddresses_many",
+        &generate_subaddresses_many,
+        "Generate the view key, spend key, and address of a range of subaddresses. 0 threads uses every core.",
+        pybind11::arg("view_key"),
+        pybind11::arg("spend_key"),
+        pybind11::arg("major"),
+        pybind11::arg("start"),
+        pybind11::arg("count"),
+        pybind11::arg("prefixes"),
+        pybind11::arg("threads") = 0
+    );
+
+    module.def(
+        "encode_context",
+        &encode_context,
+        "Encode a cold-signing context in the versioned binary format.",
+        pybind11::arg("fee"),
+        pybind11::arg("inputs"),
+        pybind11::arg("mixins"),
+        pybind11::arg("ring"),
+        pybind11::arg("outputs")
+    );
+    module.def(
+        "decode_context",
+        &decode_context,
+        "Decode a binary cold-signing context into its fee, inputs, mixins, ring, and outputs.",
+        pybind11::arg("data")
+    );
+
+    module.def(
+        "get_transaction_weight",
+        &get_transaction_weight,
+        "Calculate the exact weight of a Transaction created by this library.",
+        pybind11::arg("mixins"),
+        pybind11::arg("outputs"),
+        pybind11::arg("extra"),
+        pybind11::arg("fee"),
+        pybind11::arg("rct_type") = (uint8_t) rct::RCTTypeCLSAG
+    );
+
+    module.def("field_backend", &field_backend, "Name of the field arithmetic backend the point operations use.");
+    module.def("vector_backend", &vector_backend, "Name of the backend for the fixed-base P - sG step of scanning, selected at runtime. Shared keys always use field_backend.");
+    module.def(
+        "scan_transactions",
+        &scan_transactions,
+        "Derive the shared keys of many Transactions and the spend key of each of their outputs. 0 threads uses every core.",
+        pybind11::arg("view_key"),
+        pybind11::arg("transactions"),
+        pybind11::arg("threads") = 0,
+        pybind11::arg("variable_time") = false
+    );
+    module.def("scalarmult_base", &scalarmult_base, "Multiply the generator by a scalar, reduced mod l.", pybind11::arg("scalar"));
+    module.def(
+        "scalarmult_key",
+        &scalarmult_key,
+        "Multiply a point by a scalar, reduced mod l.",
+        pybind11::arg("point"),
+        pybind11::arg("scalar")
+    );
+    module.def("add_keys", &add_keys, "Add two points.", pybind11::arg("p"), pybind11::arg("q"));
+    module.def("sub_keys", &sub_keys, "Subtract the second point from the first.", pybind11::arg("p"), pybind11::arg("q"));
+    module.def("hash_to_scalar", &hash_to_scalar, "Keccak-256 mod l.", pybind11::arg("data"));
+    module.def(
+        "generate_key_derivation",
+        &generate_key_derivation,
+        "Generate the shared key 8aR from a point and a scalar.",
+        pybind11::arg("point"),
+        pybind11::arg("scalar")
+    );
+    module.def("commit", &commit, "Pedersen commitment to an amount with the specified mask.", pybind11::arg("amount"), pybind11::arg("mask"));
 }
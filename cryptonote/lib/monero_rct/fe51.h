@@ -0,0 +1,747 @@
+//Radix-2^51 Ed25519 point arithmetic, used for the scanning and derivation paths on 64-bit targets.
+//Field elements are five 51-bit limbs multiplied with 128-bit products, instead of ref10's ten 25.5-bit limbs.
+//The formulas and scalar recoding mirror ref10 (Monero's crypto-ops) so every result is byte-for-byte identical.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SIZEOF_INT128__) && (UINTPTR_MAX == 0xFFFFFFFFFFFFFFFFu)
+#define FE51 1
+
+namespace fe51 {
+    typedef unsigned __int128 uint128_t;
+
+    const uint64_t MASK = (((uint64_t) 1) << 51) - 1;
+
+    //Field element. Limbs are kept below 2^54 between operations.
+    struct fe {
+        uint64_t v[5];
+    };
+
+    const fe ZERO = {{0, 0, 0, 0, 0}};
+    const fe ONE = {{1, 0, 0, 0, 0}};
+    const fe D = {{0x34dca135978a3, 0x1a8283b156ebd, 0x5e7a26001c029, 0x739c663a03cbb, 0x52036cee2b6ff}};
+    const fe D2 = {{0x69b9426b2f159, 0x35050762add7a, 0x3cf44c0038052, 0x6738cc7407977, 0x2406d9dc56dff}};
+    const fe SQRTM1 = {{0x61b274a0ea0b0, 0xd5a5fc8f189d, 0x7ef5e9cbd0c60, 0x78595a6804c9e, 0x2b8324804fc1d}};
+    const fe BASE_X = {{0x62d608f25d51a, 0x412a4b4f6592a, 0x75b7171a4b31d, 0x1ff60527118fe, 0x216936d3cd6e5}};
+    const fe BASE_Y = {{0x6666666666658, 0x4cccccccccccc, 0x1999999999999, 0x3333333333333, 0x6666666666666}};
+
+    inline uint64_t load64(const unsigned char *s) {
+        uint64_t result = 0;
+        for (int i = 7; i >= 0; i--) {
+            result = (result << 8) | s[i];
+        }
+        return result;
+    }
+
+    inline void store64(unsigned char *s, uint64_t value) {
+        for (int i = 0; i < 8; i++) {
+            s[i] = (value >> (i * 8)) & 0xFF;
+        }
+    }
+
+    //Propagate the carries, folding the top limb's carry back in times 19.
+    inline void carry(fe &h) {
+        uint64_t c;
+        c = h.v[0] >> 51; h.v[0] &= MASK; h.v[1] += c;
+        c = h.v[1] >> 51; h.v[1] &= MASK; h.v[2] += c;
+        c = h.v[2] >> 51; h.v[2] &= MASK; h.v[3] += c;
+        c = h.v[3] >> 51; h.v[3] &= MASK; h.v[4] += c;
+        c = h.v[4] >> 51; h.v[4] &= MASK; h.v[0] += c * 19;
+    }
+
+    inline void frombytes(fe &h, const unsigned char *s) {
+        h.v[0] = load64(s) & MASK;
+        h.v[1] = (load64(s + 6) >> 3) & MASK;
+        h.v[2] = (load64(s + 12) >> 6) & MASK;
+        h.v[3] = (load64(s + 19) >> 1) & MASK;
+        h.v[4] = (load64(s + 24) >> 12) & MASK;
+    }
+
+    //Fully reduce and encode.
+    inline void tobytes(unsigned char *s, const fe &f) {
+        fe h = f;
+        carry(h);
+        carry(h);
+
+        //h is now below 2^255 + 2^13. Add 19 to find out if it's at least p.
+        uint64_t q = (h.v[0] + 19) >> 51;
+        q = (h.v[1] + q) >> 51;
+        q = (h.v[2] + q) >> 51;
+        q = (h.v[3] + q) >> 51;
+        q = (h.v[4] + q) >> 51;
+
+        h.v[0] += 19 * q;
+        h.v[1] += h.v[0] >> 51; h.v[0] &= MASK;
+        h.v[2] += h.v[1] >> 51; h.v[1] &= MASK;
+        h.v[3] += h.v[2] >> 51; h.v[2] &= MASK;
+        h.v[4] += h.v[3] >> 51; h.v[3] &= MASK;
+        h.v[4] &= MASK;
+
+        store64(s, h.v[0] | (h.v[1] << 51));
+        store64(s + 8, (h.v[1] >> 13) | (h.v[2] << 38));
+        store64(s + 16, (h.v[2] >> 26) | (h.v[3] << 25));
+        store64(s + 24, (h.v[3] >> 39) | (h.v[4] << 12));
+    }
+
+    inline void add(fe &h, const fe &f, const fe &g) {
+        for (int i = 0; i < 5; i++) {
+            h.v[i] = f.v[i] + g.v[i];
+        }
+    }
+
+    //f - g, computed as f + 4p - g so no limb underflows.
+    inline void sub(fe &h, const fe &f, const fe &g) {
+        h.v[0] = (f.v[0] + 0x1FFFFFFFFFFFB4) - g.v[0];
+        for (int i = 1; i < 5; i++) {
+            h.v[i] = (f.v[i] + 0x1FFFFFFFFFFFFC) - g.v[i];
+        }
+        carry(h);
+    }
+
+    inline void neg(fe &h, const fe &f) {
+        sub(h, ZERO, f);
+    }
+
+    inline void reduce(fe &h, const uint128_t r[5]) {
+        uint64_t c;
+        uint128_t r1 = r[1], r2 = r[2], r3 = r[3], r4 = r[4];
+        h.v[0] = ((uint64_t) r[0]) & MASK; c = (uint64_t) (r[0] >> 51); r1 += c;
+        h.v[1] = ((uint64_t) r1) & MASK; c = (uint64_t) (r1 >> 51); r2 += c;
+        h.v[2] = ((uint64_t) r2) & MASK; c = (uint64_t) (r2 >> 51); r3 += c;
+        h.v[3] = ((uint64_t) r3) & MASK; c = (uint64_t) (r3 >> 51); r4 += c;
+        h.v[4] = ((uint64_t) r4) & MASK; c = (uint64_t) (r4 >> 51);
+        h.v[0] += c * 19;
+        h.v[1] += h.v[0] >> 51;
+        h.v[0] &= MASK;
+    }
+
+    inline void mul(fe &h, const fe &f, const fe &g) {
+        const uint64_t *a = f.v;
+        const uint64_t *b = g.v;
+        uint64_t b1_19 = b[1] * 19, b2_19 = b[2] * 19, b3_19 = b[3] * 19, b4_19 = b[4] * 19;
+
+        uint128_t r[5];
+        r[0] = (uint128_t) a[0] * b[0] + (uint128_t) a[1] * b4_19 + (uint128_t) a[2] * b3_19
+            + (uint128_t) a[3] * b2_19 + (uint128_t) a[4] * b1_19;
+        r[1] = (uint128_t) a[0] * b[1] + (uint128_t) a[1] * b[0] + (uint128_t) a[2] * b4_19
+            + (uint128_t) a[3] * b3_19 + (uint128_t) a[4] * b2_19;
+        r[2] = (uint128_t) a[0] * b[2] + (uint128_t) a[1] * b[1] + (uint128_t) a[2] * b[0]
+            + (uint128_t) a[3] * b4_19 + (uint128_t) a[4] * b3_19;
+        r[3] = (uint128_t) a[0] * b[3] + (uint128_t) a[1] * b[2] + (uint128_t) a[2] * b[1]
+            + (uint128_t) a[3] * b[0] + (uint128_t) a[4] * b4_19;
+        r[4] = (uint128_t) a[0] * b[4] + (uint128_t) a[1] * b[3] + (uint128_t) a[2] * b[2]
+            + (uint128_t) a[3] * b[1] + (uint128_t) a[4] * b[0];
+        reduce(h, r);
+    }
+
+    inline void sq(fe &h, const fe &f) {
+        const uint64_t *a = f.v;
+        uint64_t d0 = a[0] * 2, d1 = a[1] * 2, d2 = a[2] * 2, d3 = a[3] * 2;
+        uint64_t a3_19 = a[3] * 19, a4_19 = a[4] * 19;
+
+        uint128_t r[5];
+        r[0] = (uint128_t) a[0] * a[0] + (uint128_t) d1 * a4_19 + (uint128_t) d2 * a3_19;
+        r[1] = (uint128_t) d0 * a[1] + (uint128_t) d2 * a4_19 + (uint128_t) a[3] * a3_19;
+        r[2] = (uint128_t) d0 * a[2] + (uint128_t) a[1] * a[1] + (uint128_t) d3 * a4_19;
+        r[3] = (uint128_t) d0 * a[3] + (uint128_t) d1 * a[2] + (uint128_t) a[4] * a4_19;
+        r[4] = (uint128_t) d0 * a[4] + (uint128_t) d1 * a[3] + (uint128_t) a[2] * a[2];
+        reduce(h, r);
+    }
+
+    inline void sqn(fe &h, const fe &f, int n) {
+        sq(h, f);
+        for (int i = 1; i < n; i++) {
+            sq(h, h);
+        }
+    }
+
+    //z^(2^250 - 1), plus z^11 which both exponentiation chains end with.
+    inline void pow250(fe &result, fe &z11, const fe &z) {
+        fe t0, t1, t2;
+        sq(t0, z);
+        sqn(t1, t0, 2);
+        mul(t1, z, t1);
+        mul(z11, t0, t1);
+        sq(t0, z11);
+        mul(t0, t1, t0);
+        sqn(t1, t0, 5);
+        mul(t0, t1, t0);
+        sqn(t1, t0, 10);
+        mul(t1, t1, t0);
+        sqn(t2, t1, 20);
+        mul(t1, t2, t1);
+        sqn(t1, t1, 10);
+        mul(t0, t1, t0);
+        sqn(t1, t0, 50);
+        mul(t1, t1, t0);
+        sqn(t2, t1, 100);
+        mul(t1, t2, t1);
+        sqn(t1, t1, 50);
+        mul(result, t1, t0);
+    }
+
+    //z^(p - 2).
+    inline void invert(fe &h, const fe &z) {
+        fe t, z11;
+        pow250(t, z11, z);
+        sqn(t, t, 5);
+        mul(h, t, z11);
+    }
+
+    //z^((p - 5) / 8).
+    inline void pow22523(fe &h, const fe &z) {
+        fe t, z11;
+        pow250(t, z11, z);
+        sqn(t, t, 2);
+        mul(h, t, z);
+    }
+
+    inline bool isnegative(const fe &f) {
+        unsigned char s[32];
+        tobytes(s, f);
+        return s[0] & 1;
+    }
+
+    inline bool isnonzero(const fe &f) {
+        unsigned char s[32];
+        tobytes(s, f);
+        unsigned char result = 0;
+        for (int i = 0; i < 32; i++) {
+            result |= s[i];
+        }
+        return result != 0;
+    }
+
+    //Replace f with g if b is 1, without branching on b.
+    inline void cmov(fe &f, const fe &g, uint64_t b) {
+        uint64_t mask = -b;
+        for (int i = 0; i < 5; i++) {
+            f.v[i] ^= (f.v[i] ^ g.v[i]) & mask;
+        }
+    }
+
+    //Point representations, named as in ref10.
+    struct ge_p2 {
+        fe X, Y, Z;
+    };
+
+    struct ge_p3 {
+        fe X, Y, Z, T;
+    };
+
+    struct ge_p1p1 {
+        fe X, Y, Z, T;
+    };
+
+    struct ge_cached {
+        fe YplusX, YminusX, Z, T2d;
+    };
+
+    struct ge_precomp {
+        fe yplusx, yminusx, xy2d;
+    };
+
+    inline void p3_0(ge_p3 &h) {
+        h.X = ZERO;
+        h.Y = ONE;
+        h.Z = ONE;
+        h.T = ZERO;
+    }
+
+    inline void p1p1_to_p2(ge_p2 &r, const ge_p1p1 &p) {
+        mul(r.X, p.X, p.T);
+        mul(r.Y, p.Y, p.Z);
+        mul(r.Z, p.Z, p.T);
+    }
+
+    inline void p1p1_to_p3(ge_p3 &r, const ge_p1p1 &p) {
+        mul(r.X, p.X, p.T);
+        mul(r.Y, p.Y, p.Z);
+        mul(r.Z, p.Z, p.T);
+        mul(r.T, p.X, p.Y);
+    }
+
+    inline void p3_to_p2(ge_p2 &r, const ge_p3 &p) {
+        r.X = p.X;
+        r.Y = p.Y;
+        r.Z = p.Z;
+    }
+
+    inline void p3_to_cached(ge_cached &r, const ge_p3 &p) {
+        add(r.YplusX, p.Y, p.X);
+        sub(r.YminusX, p.Y, p.X);
+        r.Z = p.Z;
+        mul(r.T2d, p.T, D2);
+    }
+
+    inline void p2_dbl(ge_p1p1 &r, const ge_p2 &p) {
+        fe t0;
+        sq(r.X, p.X);
+        sq(r.Z, p.Y);
+        sq(r.T, p.Z);
+        add(r.T, r.T, r.T);
+        add(r.Y, p.X, p.Y);
+        sq(t0, r.Y);
+        add(r.Y, r.Z, r.X);
+        sub(r.Z, r.Z, r.X);
+        sub(r.X, t0, r.Y);
+        sub(r.T, r.T, r.Z);
+    }
+
+    inline void p3_dbl(ge_p1p1 &r, const ge_p3 &p) {
+        ge_p2 q;
+        p3_to_p2(q, p);
+        p2_dbl(r, q);
+    }
+
+    inline void ge_add(ge_p1p1 &r, const ge_p3 &p, const ge_cached &q) {
+        fe t0;
+        add(r.X, p.Y, p.X);
+        sub(r.Y, p.Y, p.X);
+        mul(r.Z, r.X, q.YplusX);
+        mul(r.Y, r.Y, q.YminusX);
+        mul(r.T, q.T2d, p.T);
+        mul(r.X, p.Z, q.Z);
+        add(t0, r.X, r.X);
+        sub(r.X, r.Z, r.Y);
+        add(r.Y, r.Z, r.Y);
+        add(r.Z, t0, r.T);
+        sub(r.T, t0, r.T);
+    }
+
+    inline void ge_sub(ge_p1p1 &r, const ge_p3 &p, const ge_cached &q) {
+        fe t0;
+        add(r.X, p.Y, p.X);
+        sub(r.Y, p.Y, p.X);
+        mul(r.Z, r.X, q.YminusX);
+        mul(r.Y, r.Y, q.YplusX);
+        mul(r.T, q.T2d, p.T);
+        mul(r.X, p.Z, q.Z);
+        add(t0, r.X, r.X);
+        sub(r.X, r.Z, r.Y);
+        add(r.Y, r.Z, r.Y);
+        sub(r.Z, t0, r.T);
+        add(r.T, t0, r.T);
+    }
+
+    inline void ge_madd(ge_p1p1 &r, const ge_p3 &p, const ge_precomp &q) {
+        fe t0;
+        add(r.X, p.Y, p.X);
+        sub(r.Y, p.Y, p.X);
+        mul(r.Z, r.X, q.yplusx);
+        mul(r.Y, r.Y, q.yminusx);
+        mul(r.T, q.xy2d, p.T);
+        add(t0, p.Z, p.Z);
+        sub(r.X, r.Z, r.Y);
+        add(r.Y, r.Z, r.Y);
+        add(r.Z, t0, r.T);
+        sub(r.T, t0, r.T);
+    }
+
+    inline void p2_tobytes(unsigned char *s, const ge_p2 &h) {
+        fe recip, x, y;
+        invert(recip, h.Z);
+        mul(x, h.X, recip);
+        mul(y, h.Y, recip);
+        tobytes(s, y);
+        s[31] ^= isnegative(x) << 7;
+    }
+
+    inline void p3_tobytes(unsigned char *s, const ge_p3 &h) {
+        ge_p2 p;
+        p3_to_p2(p, h);
+        p2_tobytes(s, p);
+    }
+
+    //Decompress a point, rejecting non-canonical encodings and points not on the curve, as Monero does.
+    inline bool frombytes_vartime(ge_p3 &h, const unsigned char *s) {
+        frombytes(h.Y, s);
+        unsigned char canonical[32];
+        tobytes(canonical, h.Y);
+        canonical[31] |= s[31] & 0x80;
+        if (memcmp(canonical, s, 32) != 0) {
+            return false;
+        }
+        h.Z = ONE;
+
+        fe u, v, v3, vxx, check;
+        sq(u, h.Y);
+        mul(v, u, D);
+        sub(u, u, h.Z);
+        add(v, v, h.Z);
+
+        //x = uv^3(uv^7)^((p - 5) / 8).
+        sq(v3, v);
+        mul(v3, v3, v);
+        sq(h.X, v3);
+        mul(h.X, h.X, v);
+        mul(h.X, h.X, u);
+        pow22523(h.X, h.X);
+        mul(h.X, h.X, v3);
+        mul(h.X, h.X, u);
+
+        sq(vxx, h.X);
+        mul(vxx, vxx, v);
+        sub(check, vxx, u);
+        if (isnonzero(check)) {
+            add(check, vxx, u);
+            if (isnonzero(check)) {
+                return false;
+            }
+            mul(h.X, h.X, SQRTM1);
+        }
+
+        if (isnegative(h.X) != (s[31] >> 7)) {
+            if (!isnonzero(h.X)) {
+                return false;
+            }
+            neg(h.X, h.X);
+        }
+
+        mul(h.T, h.X, h.Y);
+        return true;
+    }
+
+    //Signed radix-16 digits of a reduced scalar, each in [-8, 8].
+    inline void recode(signed char e[64], const unsigned char *a) {
+        for (int i = 0; i < 32; i++) {
+            e[(2 * i) + 0] = (a[i] >> 0) & 15;
+            e[(2 * i) + 1] = (a[i] >> 4) & 15;
+        }
+        signed char c = 0;
+        for (int i = 0; i < 63; i++) {
+            e[i] += c;
+            c = (e[i] + 8) >> 4;
+            e[i] -= c << 4;
+        }
+        e[63] += c;
+    }
+
+    inline uint64_t equal(signed char b, signed char c) {
+        return ((uint64_t) (((unsigned char) (b ^ c)) - 1)) >> 63;
+    }
+
+    inline uint64_t negative(signed char b) {
+        return ((uint64_t) ((int64_t) b)) >> 63;
+    }
+
+    inline void cached_cmov(ge_cached &t, const ge_cached &u, uint64_t b) {
+        cmov(t.YplusX, u.YplusX, b);
+        cmov(t.YminusX, u.YminusX, b);
+        cmov(t.Z, u.Z, b);
+        cmov(t.T2d, u.T2d, b);
+    }
+
+    inline void precomp_cmov(ge_precomp &t, const ge_precomp &u, uint64_t b) {
+        cmov(t.yplusx, u.yplusx, b);
+        cmov(t.yminusx, u.yminusx, b);
+        cmov(t.xy2d, u.xy2d, b);
+    }
+
+    //Constant time selection of b times the point from its multiples 1 to 8.
+    inline void select_cached(ge_cached &t, const ge_cached table[8], signed char b) {
+        uint64_t bnegative = negative(b);
+        signed char babs = b - (((-bnegative) & b) << 1);
+
+        t.YplusX = ONE;
+        t.YminusX = ONE;
+        t.Z = ONE;
+        t.T2d = ZERO;
+        for (int i = 0; i < 8; i++) {
+            cached_cmov(t, table[i], equal(babs, i + 1));
+        }
+
+        ge_cached minust;
+        minust.YplusX = t.YminusX;
+        minust.YminusX = t.YplusX;
+        minust.Z = t.Z;
+        neg(minust.T2d, t.T2d);
+        cached_cmov(t, minust, bnegative);
+    }
+
+    inline void select_precomp(ge_precomp &t, const ge_precomp table[8], signed char b) {
+        uint64_t bnegative = negative(b);
+        signed char babs = b - (((-bnegative) & b) << 1);
+
+        t.yplusx = ONE;
+        t.yminusx = ONE;
+        t.xy2d = ZERO;
+        for (int i = 0; i < 8; i++) {
+            precomp_cmov(t, table[i], equal(babs, i + 1));
+        }
+
+        ge_precomp minust;
+        minust.yplusx = t.yminusx;
+        minust.yminusx = t.yplusx;
+        neg(minust.xy2d, t.xy2d);
+        precomp_cmov(t, minust, bnegative);
+    }
+
+    //Multiply a point by 16.
+    inline void dbl4(ge_p3 &h) {
+        ge_p1p1 r;
+        ge_p2 s;
+        p3_dbl(r, h);
+        p1p1_to_p2(s, r);
+        p2_dbl(r, s);
+        p1p1_to_p2(s, r);
+        p2_dbl(r, s);
+        p1p1_to_p2(s, r);
+        p2_dbl(r, s);
+        p1p1_to_p3(h, r);
+    }
+
+    //aA, where a is reduced. Constant time with respect to a.
+    inline void scalarmult(ge_p3 &h, const unsigned char *a, const ge_p3 &A) {
+        ge_cached table[8];
+        ge_p1p1 t;
+        ge_p3 u;
+        p3_to_cached(table[0], A);
+        for (int i = 0; i < 7; i++) {
+            ge_add(t, A, table[i]);
+            p1p1_to_p3(u, t);
+            p3_to_cached(table[i + 1], u);
+        }
+
+        signed char e[64];
+        recode(e, a);
+
+        ge_cached selected;
+        p3_0(h);
+        for (int i = 63; i >= 0; i--) {
+            dbl4(h);
+            select_cached(selected, table, e[i]);
+            ge_add(t, h, selected);
+            p1p1_to_p3(h, t);
+        }
+    }
+
+    //A fixed point's table, (j + 1) 256^i P for i in [0, 32) and j in [0, 8), in affine precomputed form.
+    //Generated at build time by fe51_tables.py, as ref10 ships its base point table.
+    struct BaseTable {
+        ge_precomp table[32][8];
+    };
+
+    const BaseTable BASE_TABLE = {{
+#include "fe51_base.h"
+    }};
+
+    //H, the amount generator of Pedersen commitments (rct::H).
+    const BaseTable H_TABLE = {{
+#include "fe51_h.h"
+    }};
+
+    inline const BaseTable &base_table() {
+        return BASE_TABLE;
+    }
+
+    inline const BaseTable &h_table() {
+        return H_TABLE;
+    }
+
+    //Add the selected multiple from each row of a table, for the digits of one parity, to h.
+    //Only the first length digits are read, so a short scalar can skip the rows its digits never reach.
+    inline void add_rows(ge_p3 &h, const BaseTable &base, const signed char e[64], int parity, int length) {
+        ge_p1p1 r;
+        ge_precomp t;
+        for (int i = parity; i < length; i += 2) {
+            select_precomp(t, base.table[i / 2], e[i]);
+            ge_madd(r, h, t);
+            p1p1_to_p3(h, r);
+        }
+    }
+
+    //aB, where a is reduced. Constant time with respect to a.
+    inline void scalarmult_base(ge_p3 &h, const unsigned char *a) {
+        const BaseTable &base = base_table();
+        signed char e[64];
+        recode(e, a);
+
+        p3_0(h);
+        add_rows(h, base, e, 1, 64);
+        dbl4(h);
+        add_rows(h, base, e, 0, 64);
+    }
+
+    //mG + aH, where m is reduced, with both tables sharing the doublings. Constant time with respect to m and a.
+    //A 64-bit amount recodes into 17 digits, so only the first 9 rows of H's table are used.
+    inline void commit(ge_p3 &h, uint64_t amount, const unsigned char *mask) {
+        const BaseTable &G = base_table();
+        const BaseTable &H = h_table();
+
+        unsigned char a[32] = {0};
+        for (int i = 0; i < 8; i++) {
+            a[i] = (amount >> (i * 8)) & 0xFF;
+        }
+        signed char m_digits[64];
+        signed char a_digits[64];
+        recode(m_digits, mask);
+        recode(a_digits, a);
+
+        p3_0(h);
+        add_rows(h, G, m_digits, 1, 64);
+        add_rows(h, H, a_digits, 1, 17);
+        dbl4(h);
+        add_rows(h, G, m_digits, 0, 64);
+        add_rows(h, H, a_digits, 0, 17);
+    }
+
+    //Operations on encoded keys. Scalars must be reduced. Return false if a point is invalid.
+    inline void scalarmult_base(unsigned char *result, const unsigned char *scalar) {
+        ge_p3 h;
+        scalarmult_base(h, scalar);
+        p3_tobytes(result, h);
+    }
+
+    inline void commit(unsigned char *result, uint64_t amount, const unsigned char *mask) {
+        ge_p3 h;
+        commit(h, amount, mask);
+        p3_tobytes(result, h);
+    }
+
+    inline bool scalarmult_key(unsigned char *result, const unsigned char *point, const unsigned char *scalar) {
+        ge_p3 A, h;
+        if (!frombytes_vartime(A, point)) {
+            return false;
+        }
+        scalarmult(h, scalar, A);
+        p3_tobytes(result, h);
+        return true;
+    }
+
+    inline bool add_keys(unsigned char *result, const unsigned char *p, const unsigned char *q, bool subtract) {
+        ge_p3 P, Q, h;
+        if ((!frombytes_vartime(P, p)) || (!frombytes_vartime(Q, q))) {
+            return false;
+        }
+        ge_cached cached;
+        ge_p1p1 t;
+        p3_to_cached(cached, Q);
+        if (subtract) {
+            ge_sub(t, P, cached);
+        } else {
+            ge_add(t, P, cached);
+        }
+        p1p1_to_p3(h, t);
+        p3_tobytes(result, h);
+        return true;
+    }
+
+    //Width-5 wNAF of 8a, for an a below 2^253. Digits are 0 or odd values in [-15, 15], with the last one used being nonzero.
+    //Recoding 8a, rather than a, folds the cofactor into the scalar multiplication without reducing it mod l, so torsion is still cleared.
+    struct Wnaf {
+        signed char digits[257];
+        int length;
+    };
+
+    inline void wnaf8(Wnaf &result, const unsigned char *a) {
+        uint64_t k[5] = {0, 0, 0, 0, 0};
+        for (int i = 0; i < 32; i++) {
+            k[i / 8] |= ((uint64_t) a[i]) << ((i % 8) * 8);
+        }
+        for (int i = 4; i > 0; i--) {
+            k[i] = (k[i] << 3) | (k[i - 1] >> 61);
+        }
+        k[0] <<= 3;
+
+        memset(result.digits, 0, sizeof(result.digits));
+        result.length = 0;
+        while ((k[0] | k[1] | k[2] | k[3] | k[4]) != 0) {
+            signed char d = 0;
+            if (k[0] & 1) {
+                d = k[0] & 31;
+                if (d >= 16) {
+                    d -= 32;
+                }
+
+                //k -= d, leaving k divisible by 32.
+                uint64_t magnitude = (d > 0) ? d : -d;
+                for (int i = 0; (i < 5) && (magnitude != 0); i++) {
+                    uint64_t before = k[i];
+                    if (d > 0) {
+                        k[i] -= magnitude;
+                        magnitude = (k[i] > before) ? 1 : 0;
+                    } else {
+                        k[i] += magnitude;
+                        magnitude = (k[i] < before) ? 1 : 0;
+                    }
+                }
+            }
+            result.digits[result.length] = d;
+            result.length++;
+
+            for (int i = 0; i < 4; i++) {
+                k[i] = (k[i] >> 1) | (k[i + 1] << 63);
+            }
+            k[4] >>= 1;
+        }
+    }
+
+    //Odd multiples of a point, 1A to 15A.
+    inline void odd_multiples(ge_cached table[8], const ge_p3 &A) {
+        ge_p1p1 t;
+        ge_p3 A2, u;
+        p3_to_cached(table[0], A);
+        p3_dbl(t, A);
+        p1p1_to_p3(A2, t);
+        for (int i = 0; i < 7; i++) {
+            ge_add(t, A2, table[i]);
+            p1p1_to_p3(u, t);
+            p3_to_cached(table[i + 1], u);
+        }
+    }
+
+    //8aR from the wNAF of 8a. Variable time with respect to a, so it's only for hosts where timing on the view key isn't a threat.
+    inline bool derivation_vartime(unsigned char *result, const unsigned char *point, const Wnaf &naf) {
+        ge_p3 R;
+        if (!frombytes_vartime(R, point)) {
+            return false;
+        }
+        ge_cached table[8];
+        odd_multiples(table, R);
+
+        ge_p1p1 t;
+        ge_p2 r;
+        ge_p3 u;
+        r.X = ZERO;
+        r.Y = ONE;
+        r.Z = ONE;
+        for (int i = naf.length - 1; i >= 0; i--) {
+            p2_dbl(t, r);
+            if (naf.digits[i] > 0) {
+                p1p1_to_p3(u, t);
+                ge_add(t, u, table[naf.digits[i] / 2]);
+            } else if (naf.digits[i] < 0) {
+                p1p1_to_p3(u, t);
+                ge_sub(t, u, table[(-naf.digits[i]) / 2]);
+            }
+            p1p1_to_p2(r, t);
+        }
+        p2_tobytes(result, r);
+        return true;
+    }
+
+    //8aR.
+    inline bool derivation(unsigned char *result, const unsigned char *point, const unsigned char *scalar) {
+        ge_p3 R, h;
+        if (!frombytes_vartime(R, point)) {
+            return false;
+        }
+        scalarmult(h, scalar, R);
+
+        ge_p1p1 t;
+        ge_p2 s;
+        p3_dbl(t, h);
+        p1p1_to_p2(s, t);
+        p2_dbl(t, s);
+        p1p1_to_p2(s, t);
+        p2_dbl(t, s);
+        p1p1_to_p2(s, t);
+        p2_tobytes(result, s);
+        return true;
+    }
+}
+#endif
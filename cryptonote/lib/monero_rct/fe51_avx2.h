@@ -0,0 +1,393 @@
+//AVX2 point arithmetic for the fixed-base P - sG step of scanning, four independent operations in lockstep, one per 64-bit lane.
+//A lockstep variable base multiplication measured even with radix-51 and was dropped, so shared key derivations stay on radix-51.
+//Field elements are ten 25.5-bit limbs per lane, multiplied with vpmuludq. Limbs are kept unsigned, so subtraction adds 4p first.
+//Decompression, compression, and the base point table are shared with the radix-51 backend, which also serves as the fallback.
+//Compiled for AVX2 regardless of the build flags and only called after the CPU was checked for it.
+
+#pragma once
+
+#include "fe51.h"
+
+#if defined(FE51) && defined(__x86_64__) && defined(__GNUC__) && (!defined(__clang__))
+#define FE51_AVX2 1
+
+#include <immintrin.h>
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+namespace fe51x4 {
+    using fe51::fe;
+
+    //Field element with one value per lane.
+    struct fe4 {
+        __m256i v[10];
+    };
+
+    inline int limb_bits(int i) {
+        return (i & 1) ? 25 : 26;
+    }
+
+    inline __m256i limb_mask(int i) {
+        return _mm256_set1_epi64x((((uint64_t) 1) << limb_bits(i)) - 1);
+    }
+
+    inline void set(fe4 &h, uint64_t value) {
+        h.v[0] = _mm256_set1_epi64x(value);
+        for (int i = 1; i < 10; i++) {
+            h.v[i] = _mm256_setzero_si256();
+        }
+    }
+
+    //Load a radix-51 element into each lane. Each 51-bit limb is split into a 26-bit and a 25-bit limb.
+    inline void pack(fe4 &h, const fe &f0, const fe &f1, const fe &f2, const fe &f3) {
+        const uint64_t MASK26 = (((uint64_t) 1) << 26) - 1;
+        for (int i = 0; i < 5; i++) {
+            h.v[(2 * i) + 0] = _mm256_set_epi64x(f3.v[i] & MASK26, f2.v[i] & MASK26, f1.v[i] & MASK26, f0.v[i] & MASK26);
+            h.v[(2 * i) + 1] = _mm256_set_epi64x(f3.v[i] >> 26, f2.v[i] >> 26, f1.v[i] >> 26, f0.v[i] >> 26);
+        }
+    }
+
+    inline void unpack(fe f[4], const fe4 &h) {
+        alignas(32) uint64_t low[4];
+        alignas(32) uint64_t high[4];
+        for (int i = 0; i < 5; i++) {
+            _mm256_store_si256((__m256i*) low, h.v[(2 * i) + 0]);
+            _mm256_store_si256((__m256i*) high, h.v[(2 * i) + 1]);
+            for (int l = 0; l < 4; l++) {
+                f[l].v[i] = low[l] + (high[l] << 26);
+            }
+        }
+    }
+
+    //19c = 16c + 2c + c. Carries can exceed 32 bits, so this doesn't use vpmuludq.
+    inline __m256i times19(__m256i c) {
+        return _mm256_add_epi64(_mm256_add_epi64(_mm256_slli_epi64(c, 4), _mm256_slli_epi64(c, 1)), c);
+    }
+
+    inline void carry_limb(fe4 &h, int i) {
+        __m256i c = _mm256_srli_epi64(h.v[i], limb_bits(i));
+        h.v[i] = _mm256_and_si256(h.v[i], limb_mask(i));
+        if (i == 9) {
+            h.v[0] = _mm256_add_epi64(h.v[0], times19(c));
+        } else {
+            h.v[i + 1] = _mm256_add_epi64(h.v[i + 1], c);
+        }
+    }
+
+    //Propagate the carries as two interleaved chains, in ref10's order, folding the top limb's carry back in times 19.
+    inline void carry(fe4 &h) {
+        carry_limb(h, 0);
+        carry_limb(h, 4);
+        carry_limb(h, 1);
+        carry_limb(h, 5);
+        carry_limb(h, 2);
+        carry_limb(h, 6);
+        carry_limb(h, 3);
+        carry_limb(h, 7);
+        carry_limb(h, 4);
+        carry_limb(h, 8);
+        carry_limb(h, 9);
+        carry_limb(h, 0);
+    }
+
+    //Not carried. The formulas below add at most three carried elements before multiplying, which mul's bounds allow.
+    inline void add(fe4 &h, const fe4 &f, const fe4 &g) {
+        for (int i = 0; i < 10; i++) {
+            h.v[i] = _mm256_add_epi64(f.v[i], g.v[i]);
+        }
+    }
+
+    //f - g, computed as f + 4p - g so no limb underflows.
+    inline void sub(fe4 &h, const fe4 &f, const fe4 &g) {
+        for (int i = 0; i < 10; i++) {
+            uint64_t p4 = ((((uint64_t) 1) << limb_bits(i)) - ((i == 0) ? 19 : 1)) * 4;
+            h.v[i] = _mm256_sub_epi64(_mm256_add_epi64(f.v[i], _mm256_set1_epi64x(p4)), g.v[i]);
+        }
+        carry(h);
+    }
+
+    //Inputs are below 2^27.7 per limb, so 19g fits in the 32 bits vpmuludq reads and the ten products sum to under 2^64.
+    inline void mul(fe4 &h, const fe4 &f, const fe4 &g) {
+        __m256i f2[10];
+        __m256i g19[10];
+        for (int i = 0; i < 10; i++) {
+            f2[i] = _mm256_add_epi64(f.v[i], f.v[i]);
+            g19[i] = times19(g.v[i]);
+        }
+
+        __m256i r[10];
+        for (int k = 0; k < 10; k++) {
+            r[k] = _mm256_setzero_si256();
+        }
+        //Fully unrolled so the limb selection and indexes are resolved at compile time.
+        #pragma GCC unroll 10
+        for (int i = 0; i < 10; i++) {
+            #pragma GCC unroll 10
+            for (int j = 0; j < 10; j++) {
+                //Two odd limbs carry an extra factor of 2, as 2^25.5 is rounded differently for each.
+                __m256i a = ((i & 1) && (j & 1)) ? f2[i] : f.v[i];
+                __m256i b = ((i + j) >= 10) ? g19[j] : g.v[j];
+                r[(i + j) % 10] = _mm256_add_epi64(r[(i + j) % 10], _mm256_mul_epu32(a, b));
+            }
+        }
+
+        for (int k = 0; k < 10; k++) {
+            h.v[k] = r[k];
+        }
+        carry(h);
+    }
+
+    //Squaring only needs the products where i <= j, doubling those where i != j.
+    inline void sq(fe4 &h, const fe4 &f) {
+        __m256i f2[10];
+        __m256i f4[10];
+        __m256i f19[10];
+        for (int i = 0; i < 10; i++) {
+            f2[i] = _mm256_add_epi64(f.v[i], f.v[i]);
+            f4[i] = _mm256_add_epi64(f2[i], f2[i]);
+            f19[i] = times19(f.v[i]);
+        }
+
+        __m256i r[10];
+        for (int k = 0; k < 10; k++) {
+            r[k] = _mm256_setzero_si256();
+        }
+        #pragma GCC unroll 10
+        for (int i = 0; i < 10; i++) {
+            #pragma GCC unroll 10
+            for (int j = i; j < 10; j++) {
+                int factor = ((i != j) ? 2 : 1) * (((i & 1) && (j & 1)) ? 2 : 1);
+                __m256i a = (factor == 4) ? f4[i] : ((factor == 2) ? f2[i] : f.v[i]);
+                __m256i b = ((i + j) >= 10) ? f19[j] : f.v[j];
+                r[(i + j) % 10] = _mm256_add_epi64(r[(i + j) % 10], _mm256_mul_epu32(a, b));
+            }
+        }
+
+        for (int k = 0; k < 10; k++) {
+            h.v[k] = r[k];
+        }
+        carry(h);
+    }
+
+    struct ge4_p2 {
+        fe4 X, Y, Z;
+    };
+
+    struct ge4_p3 {
+        fe4 X, Y, Z, T;
+    };
+
+    struct ge4_p1p1 {
+        fe4 X, Y, Z, T;
+    };
+
+    struct ge4_cached {
+        fe4 YplusX, YminusX, Z, T2d;
+    };
+
+    struct ge4_precomp {
+        fe4 yplusx, yminusx, xy2d;
+    };
+
+    inline void p3_0(ge4_p3 &h) {
+        set(h.X, 0);
+        set(h.Y, 1);
+        set(h.Z, 1);
+        set(h.T, 0);
+    }
+
+    inline void pack(ge4_p3 &h, const fe51::ge_p3 p[4]) {
+        pack(h.X, p[0].X, p[1].X, p[2].X, p[3].X);
+        pack(h.Y, p[0].Y, p[1].Y, p[2].Y, p[3].Y);
+        pack(h.Z, p[0].Z, p[1].Z, p[2].Z, p[3].Z);
+        pack(h.T, p[0].T, p[1].T, p[2].T, p[3].T);
+    }
+
+    inline void unpack(fe51::ge_p2 p[4], const ge4_p2 &h) {
+        fe X[4], Y[4], Z[4];
+        unpack(X, h.X);
+        unpack(Y, h.Y);
+        unpack(Z, h.Z);
+        for (int l = 0; l < 4; l++) {
+            p[l].X = X[l];
+            p[l].Y = Y[l];
+            p[l].Z = Z[l];
+        }
+    }
+
+    inline void p1p1_to_p2(ge4_p2 &r, const ge4_p1p1 &p) {
+        mul(r.X, p.X, p.T);
+        mul(r.Y, p.Y, p.Z);
+        mul(r.Z, p.Z, p.T);
+    }
+
+    inline void p1p1_to_p3(ge4_p3 &r, const ge4_p1p1 &p) {
+        mul(r.X, p.X, p.T);
+        mul(r.Y, p.Y, p.Z);
+        mul(r.Z, p.Z, p.T);
+        mul(r.T, p.X, p.Y);
+    }
+
+    inline void p3_to_p2(ge4_p2 &r, const ge4_p3 &p) {
+        r.X = p.X;
+        r.Y = p.Y;
+        r.Z = p.Z;
+    }
+
+    inline void p3_to_cached(ge4_cached &r, const ge4_p3 &p) {
+        fe4 d2;
+        pack(d2, fe51::D2, fe51::D2, fe51::D2, fe51::D2);
+        add(r.YplusX, p.Y, p.X);
+        sub(r.YminusX, p.Y, p.X);
+        r.Z = p.Z;
+        mul(r.T2d, p.T, d2);
+    }
+
+    inline void p2_dbl(ge4_p1p1 &r, const ge4_p2 &p) {
+        fe4 t0;
+        sq(r.X, p.X);
+        sq(r.Z, p.Y);
+        sq(r.T, p.Z);
+        add(r.T, r.T, r.T);
+        add(r.Y, p.X, p.Y);
+        sq(t0, r.Y);
+        add(r.Y, r.Z, r.X);
+        sub(r.Z, r.Z, r.X);
+        sub(r.X, t0, r.Y);
+        sub(r.T, r.T, r.Z);
+    }
+
+    inline void ge_sub(ge4_p1p1 &r, const ge4_p3 &p, const ge4_cached &q) {
+        fe4 t0;
+        add(r.X, p.Y, p.X);
+        sub(r.Y, p.Y, p.X);
+        mul(r.Z, r.X, q.YminusX);
+        mul(r.Y, r.Y, q.YplusX);
+        mul(r.T, q.T2d, p.T);
+        mul(r.X, p.Z, q.Z);
+        add(t0, r.X, r.X);
+        sub(r.X, r.Z, r.Y);
+        add(r.Y, r.Z, r.Y);
+        sub(r.Z, t0, r.T);
+        add(r.T, t0, r.T);
+    }
+
+    inline void ge_madd(ge4_p1p1 &r, const ge4_p3 &p, const ge4_precomp &q) {
+        fe4 t0;
+        add(r.X, p.Y, p.X);
+        sub(r.Y, p.Y, p.X);
+        mul(r.Z, r.X, q.yplusx);
+        mul(r.Y, r.Y, q.yminusx);
+        mul(r.T, q.xy2d, p.T);
+        add(t0, p.Z, p.Z);
+        sub(r.X, r.Z, r.Y);
+        add(r.Y, r.Z, r.Y);
+        add(r.Z, t0, r.T);
+        sub(r.T, t0, r.T);
+    }
+
+    //Multiply each lane by 16.
+    inline void dbl4(ge4_p3 &h) {
+        ge4_p1p1 r;
+        ge4_p2 s;
+        p3_to_p2(s, h);
+        for (int i = 0; i < 3; i++) {
+            p2_dbl(r, s);
+            p1p1_to_p2(s, r);
+        }
+        p2_dbl(r, s);
+        p1p1_to_p3(h, r);
+    }
+
+    //Select each lane's multiple of the base point table row, with the radix-51 constant time selection.
+    inline void select_precomp(ge4_precomp &t, const fe51::ge_precomp row[8], const signed char b[4]) {
+        fe51::ge_precomp selected[4];
+        for (int l = 0; l < 4; l++) {
+            fe51::select_precomp(selected[l], row, b[l]);
+        }
+        pack(t.yplusx, selected[0].yplusx, selected[1].yplusx, selected[2].yplusx, selected[3].yplusx);
+        pack(t.yminusx, selected[0].yminusx, selected[1].yminusx, selected[2].yminusx, selected[3].yminusx);
+        pack(t.xy2d, selected[0].xy2d, selected[1].xy2d, selected[2].xy2d, selected[3].xy2d);
+    }
+
+    //Four lanes of aB.
+    inline void scalarmult_base(ge4_p3 &h, const signed char e[4][64]) {
+        const fe51::BaseTable &base = fe51::base_table();
+        ge4_p1p1 r;
+        ge4_precomp t;
+        signed char b[4];
+        p3_0(h);
+        for (int i = 1; i < 64; i += 2) {
+            for (int l = 0; l < 4; l++) {
+                b[l] = e[l][i];
+            }
+            select_precomp(t, base.table[i / 2], b);
+            ge_madd(r, h, t);
+            p1p1_to_p3(h, r);
+        }
+        dbl4(h);
+        for (int i = 0; i < 64; i += 2) {
+            for (int l = 0; l < 4; l++) {
+                b[l] = e[l][i];
+            }
+            select_precomp(t, base.table[i / 2], b);
+            ge_madd(r, h, t);
+            p1p1_to_p3(h, r);
+        }
+    }
+
+    //Decompress four points. Invalid points are replaced with the base point so their lanes can still run.
+    inline void decompress(ge4_p3 &h, const unsigned char points[4][32], bool valid[4]) {
+        fe51::ge_p3 decoded[4];
+        for (int l = 0; l < 4; l++) {
+            valid[l] = fe51::frombytes_vartime(decoded[l], points[l]);
+            if (!valid[l]) {
+                decoded[l].X = fe51::BASE_X;
+                decoded[l].Y = fe51::BASE_Y;
+                decoded[l].Z = fe51::ONE;
+                fe51::mul(decoded[l].T, fe51::BASE_X, fe51::BASE_Y);
+            }
+        }
+        pack(h, decoded);
+    }
+
+    inline void compress(unsigned char results[4][32], const ge4_p2 &h) {
+        fe51::ge_p2 unpacked[4];
+        unpack(unpacked, h);
+        for (int l = 0; l < 4; l++) {
+            fe51::p2_tobytes(results[l], unpacked[l]);
+        }
+    }
+
+    //P - sG for four Ps and four reduced scalars.
+    inline void sub_base(unsigned char results[4][32], const unsigned char points[4][32], const unsigned char scalars[4][32], bool valid[4]) {
+        ge4_p3 P, sG;
+        decompress(P, points, valid);
+
+        signed char e[4][64];
+        for (int l = 0; l < 4; l++) {
+            fe51::recode(e[l], scalars[l]);
+        }
+        scalarmult_base(sG, e);
+
+        ge4_cached cached;
+        ge4_p1p1 t;
+        ge4_p2 s;
+        p3_to_cached(cached, sG);
+        ge_sub(t, P, cached);
+        p1p1_to_p2(s, t);
+        compress(results, s);
+    }
+}
+
+#pragma GCC pop_options
+
+namespace fe51x4 {
+    //Checked through CPUID.
+    inline bool supported() {
+        static const bool result = __builtin_cpu_supports("avx2");
+        return result;
+    }
+}
+#endif
@@ -0,0 +1,89 @@
+"""
+Generate the radix-51 backend's fixed-base tables, for G and H, at build time.
+Each table is (j + 1) 256^i P for i in [0, 32) and j in [0, 8), in ref10's affine precomputed form.
+Writes the initializers fe51.h includes, with every coordinate fully reduced into five 51-bit limbs.
+"""
+
+# Types.
+from typing import List, Tuple
+
+# Field modulus and curve constant.
+q: int = 2 ** 255 - 19
+d: int = -121665 * pow(121666, q - 2, q) % q
+
+# H, the amount generator of Pedersen commitments (rct::H).
+H_BYTES: bytes = bytes.fromhex(
+    "8b655970153799af2aeadc9ff1add0ea6c7251d54154cfa92c173a0dd39c1f94"
+)
+
+Point = Tuple[int, int]
+
+
+def inv(x: int) -> int:
+    return pow(x, q - 2, q)
+
+
+def decompress(encoded: bytes) -> Point:
+    """Decompress a point, choosing x by the sign bit."""
+
+    y: int = int.from_bytes(encoded, byteorder="little") & ((1 << 255) - 1)
+    xx: int = (y * y - 1) * inv(d * y * y + 1) % q
+    x: int = pow(xx, (q + 3) // 8, q)
+    if (x * x - xx) % q != 0:
+        x = x * pow(2, (q - 1) // 4, q) % q
+    if (x * x - xx) % q != 0:
+        raise Exception("Point isn't on the curve.")
+    if (x & 1) != (encoded[31] >> 7):
+        x = q - x
+    return (x, y)
+
+
+def add(P: Point, Q: Point) -> Point:
+    """Add two points in affine coordinates."""
+
+    dxy: int = d * P[0] * Q[0] * P[1] * Q[1] % q
+    return (
+        (P[0] * Q[1] + Q[0] * P[1]) * inv(1 + dxy) % q,
+        (P[1] * Q[1] + P[0] * Q[0]) * inv(1 - dxy) % q,
+    )
+
+
+def limbs(x: int) -> str:
+    """Encode a reduced field element as an fe initializer."""
+
+    mask: int = (1 << 51) - 1
+    return "{{" + ", ".join(hex((x >> (51 * i)) & mask) for i in range(5)) + "}}"
+
+
+def table(P: Point) -> str:
+    """Build the initializer of a point's table."""
+
+    rows: List[str] = []
+    for _ in range(32):
+        multiples: List[str] = []
+        multiple: Point = P
+        for _ in range(8):
+            x, y = multiple
+            multiples.append(
+                "{"
+                + ", ".join(
+                    [limbs((y + x) % q), limbs((y - x) % q), limbs(2 * d * x * y % q)]
+                )
+                + "}"
+            )
+            multiple = add(multiple, P)
+
+        rows.append("{\n    " + ",\n    ".join(multiples) + "\n}")
+
+        # 256P.
+        for _ in range(8):
+            P = add(P, P)
+    return ",\n".join(rows) + "\n"
+
+
+if __name__ == "__main__":
+    G: Point = decompress((4 * inv(5) % q).to_bytes(32, byteorder="little"))
+    with open("fe51_base.h", "w") as file:
+        file.write(table(G))
+    with open("fe51_h.h", "w") as file:
+        file.write(table(decompress(H_BYTES)))
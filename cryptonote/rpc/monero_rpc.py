@@ -13,6 +13,9 @@ from cryptonote.classes.blockchain import BlockHeader, Block
 # RPC class.
 from cryptonote.rpc.rpc import RPC
 
+# Most outputs a restricted daemon returns from a single get_outs request.
+MAX_OUTS_PER_REQUEST: int = 5000
+
 
 class MoneroRPC(RPC):
     """Monero RPC. Only provides methods available by Monero."""
@@ -114,10 +117,29 @@ class MoneroRPC(RPC):
     def get_outs(self, index: int) -> Dict[str, Any]:
         """Get output information based on its index."""
 
-        return self.rpc_request(
-            "get_outs.bin",
-            {"outputs": (0x80 | 12, [{"amount": (5, 0), "index": (5, index)}])},
-        )["outs"][0]
+        return self.get_outs_many([index])[0]
+
+    def get_outs_many(self, indexes: List[int]) -> List[Dict[str, Any]]:
+        """
+        Get output information for multiple indexes.
+        Uses as few requests as the daemon's limit on outputs per request allows.
+        """
+
+        result: List[Dict[str, Any]] = []
+        for i in range(0, len(indexes), MAX_OUTS_PER_REQUEST):
+            result += self.rpc_request(
+                "get_outs.bin",
+                {
+                    "outputs": (
+                        0x80 | 12,
+                        [
+                            {"amount": (5, 0), "index": (5, index)}
+                            for index in indexes[i : i + MAX_OUTS_PER_REQUEST]
+                        ],
+                    )
+                },
+            )["outs"]
+        return result
 
     def get_fee_estimate(self) -> Tuple[int, int]:
         """Get an estimate of the fee per byte, along with the quantization mask."""
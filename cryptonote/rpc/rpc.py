@@ -291,6 +291,11 @@ class RPC(ABC):
     def get_outs(self, index: int) -> Dict[str, Any]:
         """Get output information based on its index."""
 
+    def get_outs_many(self, indexes: List[int]) -> List[Dict[str, Any]]:
+        """Get output information for multiple indexes. Makes a request per index unless overridden."""
+
+        return [self.get_outs(index) for index in indexes]
+
     @abstractmethod
     def get_fee_estimate(self) -> Tuple[int, int]:
         """Get an estimate of the fee per byte, along with the quantization mask."""
@@ -40,20 +40,28 @@ def build_monero() -> None:
 
     chdir("..")
 
+    # Generate the fixed-base tables the radix-51 backend includes.
+    check_call([sys.executable, "fe51_tables.py"])
+    print("Generated the fixed-base tables.")
+
     suffix: Optional[str] = sysconfig.get_config_var("EXT_SUFFIX")
     if suffix is None:
         suffix = ".so"
     wrapper_build: List[str] = (
-        "g++ -O3 -Wall -shared -std=c++14 -fPIC".split()
+        "g++ -O3 -Wall -shared -std=c++14 -fPIC -pthread".split()
         + check_output([sys.executable] + "-m pybind11 --includes".split())
         .decode("utf-8")
         .split()
-        + "-Imonero/contrib/epee/include -Imonero/src c_monero_rct.cpp -o".split()
+        + "-Imonero/contrib/epee/include -Imonero/src".split()
+        + "-Imonero/external/db_drivers/liblmdb c_monero_rct.cpp -o".split()
         + ("c_monero_rct" + suffix).strip().split()
+        + "-Lmonero/src/common -lcommon".split()
         + "-Lmonero/src/crypto -lcncrypto".split()
         + "-Lmonero/src/device -ldevice".split()
         + "-Lmonero/src/ringct -lringct_basic -lringct".split()
+        + "-Lmonero/src/cryptonote_basic -lcryptonote_basic".split()
         + "-Lmonero/src/cryptonote_core -lcryptonote_core".split()
+        + "-Lmonero/external/db_drivers/liblmdb -llmdb".split()
     )
     check_call(wrapper_build)
     print("Built the wrapper around Monero's shared libraries.")
@@ -1,7 +1,10 @@
-from typing import List, Tuple
+from typing import Dict, List, Tuple, Optional, Union, overload
+
+BufferLike = Union[bytes, bytearray, memoryview]
 
 class Key:
     def __getitem__(self, i: int) -> int: ...
+    def __bytes__(self) -> bytes: ...
 
 class CTKey:
     dest: Key
@@ -29,6 +32,20 @@ class Bulletproof:
     b: Key
     t: Key
 
+class BulletproofPlus:
+    v: List[Key]
+
+    capital_a: Key
+    capital_a1: Key
+    capital_b: Key
+
+    r1: Key
+    s1: Key
+    d1: Key
+
+    l: List[Key]
+    r: List[Key]
+
 class CLSAGSignature:
     s: List[Key]
     c1: Key
@@ -37,14 +54,134 @@ class CLSAGSignature:
 class RingCTPrunable:
     pseudo_outs: List[Key]
     bulletproofs: List[Bulletproof]
+    bulletproofs_plus: List[BulletproofPlus]
     CLSAGs: List[CLSAGSignature]
 
 class RingCTSignatures:
+    type: int
     ecdh_info: List[ECDHTuple]
     out_public_keys: List[CTKey]
     prunable: RingCTPrunable
 
-def generate_key_image(priv_key: bytes, pub_key: bytes) -> bytes: ...
+class OutputStore:
+    allocated: int
+    def __init__(self) -> None: ...
+    def __len__(self) -> int: ...
+    def find(self, tx_hash: bytes, index: int) -> int: ...
+    def add(
+        self,
+        tx_hash: bytes,
+        index: int,
+        timelock: int,
+        amount: int,
+        spend_key: bytes,
+        subaddress: Tuple[int, int],
+        amount_key: bytes,
+        commitment: bytes,
+        state: int,
+        monero: bool,
+    ) -> int: ...
+    def tx_hash(self, record: int) -> bytes: ...
+    def index(self, record: int) -> int: ...
+    def timelock(self, record: int) -> int: ...
+    def amount(self, record: int) -> int: ...
+    def spend_key(self, record: int) -> bytes: ...
+    def subaddress(self, record: int) -> Tuple[int, int]: ...
+    def amount_key(self, record: int) -> bytes: ...
+    def commitment(self, record: int) -> bytes: ...
+    def state(self, record: int) -> int: ...
+    def monero(self, record: int) -> bool: ...
+    def set_state(self, record: int, state: int) -> None: ...
+    def index_keys(self) -> List[Tuple[int, int, bytes, int]]: ...
+    def totals(
+        self, height: int
+    ) -> Tuple[
+        Dict[Tuple[int, int], Tuple[int, int, int]], List[Tuple[int, bytes, int]]
+    ]: ...
+
+class InputKeys:
+    def __init__(self) -> None: ...
+    def __len__(self) -> int: ...
+    def add(self, key: Tuple[int, int, bytes, int]) -> bool: ...
+    def remove(self, key: Tuple[int, int, bytes, int]) -> bool: ...
+    def load(self, keys: List[Tuple[int, int, bytes, int]]) -> None: ...
+    def list(self) -> List[Tuple[int, int, bytes, int]]: ...
+    def ceiling(
+        self, amount: int, height: int, excluded: List[Tuple[int, int, bytes, int]]
+    ) -> Optional[Tuple[int, int, bytes, int]]: ...
+    def largest(
+        self, count: int, minimum: int, height: int
+    ) -> List[Tuple[int, int, bytes, int]]: ...
+    def below(self, amount: int, height: int) -> List[Tuple[int, int, bytes, int]]: ...
+    def fit(
+        self, count: int, target: int, minimum: int, height: int
+    ) -> List[Tuple[int, int, bytes, int]]: ...
+
+class WalletDB:
+    def __init__(self, path: str, map_size: int = 1 << 32) -> None: ...
+    def checkpoint(self) -> Optional[Tuple[int, bytes]]: ...
+    def load(self, store: OutputStore) -> int: ...
+    def subaddresses(self) -> List[Tuple[bytes, int, int]]: ...
+    def key_image(self, image: bytes) -> Optional[Tuple[bytes, int]]: ...
+    def commit(
+        self,
+        store: OutputStore,
+        subaddresses: List[Tuple[bytes, int, int]],
+        key_images: List[Tuple[bytes, bytes, int]],
+        checkpoint: Optional[Tuple[int, bytes]] = None,
+    ) -> None: ...
+
+class Signer:
+    warm: bool
+    rct_type: int
+    arena_allocations: int
+    signatures: int
+    def __init__(self, rct_type: int = 5) -> None: ...
+    def warm_up(self) -> None: ...
+    @overload
+    def sign(
+        self,
+        prefix_hash: bytes,
+        private_keys: List[Tuple[bytes, bytes]],
+        destinations: List[bytes],
+        amount_keys: List[bytes],
+        ring: List[List[List[bytes]]],
+        indexes: List[int],
+        inputs: List[int],
+        outputs: List[int],
+        fee: int,
+    ) -> RingCTSignatures: ...
+    @overload
+    def sign(
+        self,
+        prefix_hash: bytes,
+        private_keys: BufferLike,
+        destinations: BufferLike,
+        amount_keys: BufferLike,
+        ring: BufferLike,
+        indexes: List[int],
+        inputs: List[int],
+        outputs: List[int],
+        fee: int,
+    ) -> RingCTSignatures: ...
+
+def generate_key_image(priv_key: bytes, pub_key: Optional[bytes] = None) -> bytes: ...
+def generate_subaddress_private_spend_key(
+    view_key: bytes, spend_key: bytes, index: Tuple[int, int]
+) -> bytes: ...
+def generate_input_key(amount_key: bytes, spend_key: bytes) -> bytes: ...
+def generate_subaddress_key_pair(
+    view_key: bytes, spend_key: bytes, index: Tuple[int, int]
+) -> Tuple[bytes, bytes]: ...
+def generate_key_images_many(
+    view_key: bytes,
+    spend_key: bytes,
+    outputs: List[Tuple[bytes, Tuple[int, int]]],
+    threads: int = 0,
+) -> List[bytes]: ...
+def generate_input_keys_many(
+    inputs: List[Tuple[bytes, bytes]], threads: int = 0
+) -> List[Tuple[bytes, bytes]]: ...
 def generate_ringct_signatures(
     prefix_hash: bytes,
     private_keys: List[Tuple[bytes, bytes]],
@@ -55,4 +192,81 @@ def generate_ringct_signatures(
     inputs: List[int],
     outputs: List[int],
     fee: int,
+    rct_type: int = 5,
 ) -> RingCTSignatures: ...
+def verify_transactions(
+    transactions: List[Tuple[bytes, Dict[int, Tuple[bytes, bytes]]]], threads: int = 0
+) -> List[bool]: ...
+def serialize_transaction_prefix(
+    inputs: List[Tuple[List[int], bytes]],
+    output_keys: List[bytes],
+    view_tags: bytes,
+    extra: bytes,
+) -> Tuple[bytes, bytes]: ...
+def serialize_transaction(
+    inputs: List[Tuple[List[int], bytes]],
+    output_keys: List[bytes],
+    view_tags: bytes,
+    extra: bytes,
+    signatures: RingCTSignatures,
+) -> Tuple[bytes, bytes]: ...
+def get_transaction_hashes(transactions: List[bytes], threads: int = 0) -> List[bytes]: ...
+def encode_addresses_many(
+    addresses: List[Tuple[bytes, bytes, bytes, bytes]],
+    payment_id_leading: bool,
+    threads: int = 0,
+) -> List[str]: ...
+def decode_addresses_many(
+    addresses: List[str],
+    prefix_length: int,
+    payment_id_leading: bool,
+    threads: int = 0,
+) -> List[Optional[Tuple[bytes, bytes, bytes, bytes]]]: ...
+def generate_subaddresses_many(
+    view_key: bytes,
+    spend_key: bytes,
+    major: int,
+    start: int,
+    count: int,
+    prefixes: Tuple[bytes, bytes],
+    threads: int = 0,
+) -> List[Tuple[bytes, bytes, str]]: ...
+
+ContextInput = Tuple[
+    bytes, int, int, int, bytes, Tuple[int, int], bytes, bytes, int, int
+]
+
+def encode_context(
+    fee: int,
+    inputs: List[ContextInput],
+    mixins: List[List[int]],
+    ring: List[List[List[bytes]]],
+    outputs: List[Tuple[str, int]],
+) -> bytes: ...
+def decode_context(
+    data: BufferLike,
+) -> Tuple[
+    int,
+    List[ContextInput],
+    List[List[int]],
+    List[List[List[bytes]]],
+    List[Tuple[str, int]],
+]: ...
+def get_transaction_weight(
+    mixins: List[List[int]], outputs: int, extra: int, fee: int, rct_type: int = 5
+) -> int: ...
+def field_backend() -> str: ...
+def vector_backend() -> str: ...
+def scan_transactions(
+    view_key: bytes,
+    transactions: List[Tuple[List[bytes], List[bytes]]],
+    threads: int = 0,
+    variable_time: bool = False,
+) -> List[Tuple[List[bytes], List[List[bytes]]]]: ...
+def scalarmult_base(scalar: bytes) -> bytes: ...
+def scalarmult_key(point: bytes, scalar: bytes) -> bytes: ...
+def add_keys(p: bytes, q: bytes) -> bytes: ...
+def sub_keys(p: bytes, q: bytes) -> bytes: ...
+def hash_to_scalar(data: bytes) -> bytes: ...
+def generate_key_derivation(point: bytes, scalar: bytes) -> bytes: ...
+def commit(amount: int, mask: bytes) -> bytes: ...
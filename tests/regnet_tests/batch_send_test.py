@@ -0,0 +1,71 @@
+# Types.
+from typing import Dict, List, Tuple, Any
+
+# urandom standard function.
+from os import urandom
+
+# JSON standard lib.
+import json
+
+# Address class.
+from cryptonote.classes.wallet.address import Address
+
+# Wallet classes.
+from cryptonote.classes.wallet.wallet import Wallet, WatchWallet
+
+# Test fixtures.
+from tests.regnet_tests.conftest import Harness
+
+# 1 XMR.
+ATOMIC_XMR: int = 1000000000000
+
+
+def batch_send_test(harness: Harness) -> None:
+    # Wallets.
+    wallet: Wallet = Wallet(harness.crypto, urandom(32))
+    recipient: Wallet = Wallet(harness.crypto, urandom(32))
+
+    # WatchWallets.
+    watch: WatchWallet = WatchWallet(
+        harness.crypto,
+        harness.rpc,
+        wallet.private_view_key,
+        wallet.public_spend_key,
+        harness.rpc.get_block_count() - 1,
+    )
+    recipient_watch: WatchWallet = WatchWallet(
+        harness.crypto,
+        harness.rpc,
+        recipient.private_view_key,
+        recipient.public_spend_key,
+        harness.rpc.get_block_count() - 1,
+    )
+
+    # Fund it with an input per Transaction.
+    harness.send(watch.new_address((0, 0)), ATOMIC_XMR)
+    harness.send(watch.new_address((0, 0)), ATOMIC_XMR)
+    watch.poll_blocks()
+
+    # Pay 20 subaddresses.
+    payouts: List[Tuple[Address, int]] = [
+        (recipient_watch.new_address((0, i + 1)), (ATOMIC_XMR // 100) + i)
+        for i in range(20)
+    ]
+    contexts: List[Dict[str, Any]] = watch.prepare_sends(payouts)
+    assert [len(context["outputs"]) for context in contexts] == [15, 5]
+
+    # Sign and publish them.
+    sends: List[Tuple[bool, Dict[str, Any], str]] = []
+    for context in contexts:
+        publishable: List[str] = wallet.sign(json.loads(json.dumps(context)))
+        sends.append((True, context, publishable[1]))
+    assert watch.finalize_sends(sends) == [True, True]
+    harness.wait_for_unlock()
+
+    # Verify every payout was received.
+    received: List[int] = sorted(
+        [output.amount for output in recipient_watch.poll_blocks().values()]
+    )
+    assert received == [payout[1] for payout in payouts]
+
+    harness.return_funds(wallet, watch, 0)
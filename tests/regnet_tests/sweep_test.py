@@ -0,0 +1,66 @@
+# Types.
+from typing import Dict, List, Tuple, Any
+
+# urandom standard function.
+from os import urandom
+
+# JSON standard lib.
+import json
+
+# Address class.
+from cryptonote.classes.wallet.address import Address
+
+# Wallet classes.
+from cryptonote.classes.wallet.wallet import Wallet, WatchWallet
+
+# Test fixtures.
+from tests.regnet_tests.conftest import Harness
+
+# 1 XMR.
+ATOMIC_XMR: int = 1000000000000
+
+
+def sweep_test(harness: Harness) -> None:
+    # Wallet.
+    wallet: Wallet = Wallet(harness.crypto, urandom(32))
+
+    # WatchWallet.
+    watch: WatchWallet = WatchWallet(
+        harness.crypto,
+        harness.rpc,
+        wallet.private_view_key,
+        wallet.public_spend_key,
+        harness.rpc.get_block_count() - 1,
+    )
+
+    # Send it dust.
+    harness.poll_blocks()
+    payouts: List[Tuple[Address, int]] = [
+        (watch.new_address((0, 0)), ATOMIC_XMR // 100) for _ in range(20)
+    ]
+    sends: List[Tuple[bool, Dict[str, Any], str]] = []
+    for context in harness.watch.prepare_sends(payouts, ATOMIC_XMR // 10):
+        publishable: List[str] = harness.wallet.sign(json.loads(json.dumps(context)))
+        sends.append((True, context, publishable[1]))
+    assert harness.watch.finalize_sends(sends) == [True, True]
+    harness.wait_for_unlock()
+    watch.poll_blocks()
+
+    # Sweep it into a single Transaction.
+    contexts: List[Dict[str, Any]] = watch.prepare_sweep(
+        watch.new_address((0, 0)), ATOMIC_XMR // 10
+    )
+    assert len(contexts) == 1
+    assert len(contexts[0]["inputs"]) == 20
+    assert (
+        sum([output["amount"] for output in contexts[0]["outputs"]])
+        + contexts[0]["fee"]
+        == (ATOMIC_XMR // 100) * 20
+    )
+
+    publishable = wallet.sign(json.loads(json.dumps(contexts[0])))
+    assert watch.finalize_send(True, contexts[0], publishable[1])
+    harness.wait_for_unlock()
+    assert len(watch.poll_blocks()) == 2
+
+    harness.return_funds(wallet, watch, 0)
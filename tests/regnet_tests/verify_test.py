@@ -0,0 +1,66 @@
+# Types.
+from typing import Dict, List, Any
+
+# urandom standard function.
+from os import urandom
+
+# JSON standard lib.
+import json
+
+# OutputIndex class.
+from cryptonote.classes.blockchain import OutputIndex
+
+# InputState class.
+from cryptonote.crypto.crypto import InputState
+
+# Wallet classes.
+from cryptonote.classes.wallet.wallet import Wallet, WatchWallet
+
+# Test fixtures.
+from tests.regnet_tests.conftest import Harness
+
+# 1 XMR.
+ATOMIC_XMR: int = 1000000000000
+
+
+def verify_test(harness: Harness) -> None:
+    # Wallet.
+    wallet: Wallet = Wallet(harness.crypto, urandom(32))
+
+    # WatchWallet.
+    watch: WatchWallet = WatchWallet(
+        harness.crypto,
+        harness.rpc,
+        wallet.private_view_key,
+        wallet.public_spend_key,
+        harness.rpc.get_block_count() - 1,
+    )
+
+    # Fund it.
+    harness.send(watch.new_address((0, 0)), ATOMIC_XMR)
+    watch.poll_blocks()
+
+    # Sign a send back and tamper with its last pseudo output.
+    context: Dict[str, Any] = watch.prepare_send(
+        harness.watch.new_address((0, 0)),
+        ATOMIC_XMR // 2,
+        (ATOMIC_XMR // 10) - 1,
+    )
+    publishable: List[str] = wallet.sign(json.loads(json.dumps(context)))
+    tampered: bytearray = bytearray.fromhex(publishable[1])
+    tampered[-1] ^= 1
+
+    # Verify it's rejected before being published and its input is usable again.
+    assert watch.finalize_sends(
+        [(True, context, tampered.hex()), (False, context, publishable[1])]
+    ) == [False, False]
+    for input_i in context["inputs"]:
+        assert (
+            watch.inputs[
+                OutputIndex(bytes.fromhex(input_i["hash"]), input_i["index"])
+            ].state
+            == InputState.Spendable
+        )
+
+    # Send back to the master wallet.
+    harness.return_funds(wallet, watch, ATOMIC_XMR)
@@ -0,0 +1,63 @@
+# Types.
+from typing import Dict, List, Any
+
+# urandom standard function.
+from os import urandom
+
+# JSON standard lib.
+import json
+
+# Transaction weight and hash functions.
+from cryptonote.lib.monero_rct.c_monero_rct import (
+    get_transaction_weight,
+    get_transaction_hashes,
+)
+
+# Wallet classes.
+from cryptonote.classes.wallet.wallet import Wallet, WatchWallet
+
+# Test fixtures.
+from tests.regnet_tests.conftest import Harness
+
+# 1 XMR.
+ATOMIC_XMR: int = 1000000000000
+
+
+def weight_test(harness: Harness) -> None:
+    # Wallet.
+    wallet: Wallet = Wallet(harness.crypto, urandom(32))
+
+    # WatchWallet.
+    watch: WatchWallet = WatchWallet(
+        harness.crypto,
+        harness.rpc,
+        wallet.private_view_key,
+        wallet.public_spend_key,
+        harness.rpc.get_block_count() - 1,
+    )
+
+    # Fund it.
+    harness.send(watch.new_address((0, 0)), ATOMIC_XMR)
+    watch.poll_blocks()
+
+    # Send back to a standard address so both outputs share an R and extra is just that R.
+    context: Dict[str, Any] = watch.prepare_send(
+        harness.watch.new_address((0, 0)),
+        ATOMIC_XMR // 2,
+        (ATOMIC_XMR // 10) - 1,
+    )
+    publishable: List[str] = wallet.sign(json.loads(json.dumps(context)))
+
+    # Two outputs have no clawback, so the weight is the serialized length.
+    assert get_transaction_weight(
+        context["mixins"], 2, 33, context["fee"], harness.crypto.rct_type.value
+    ) == len(bytes.fromhex(publishable[1]))
+
+    # Hashing the parsed Transaction matches the hash from signing.
+    assert get_transaction_hashes([bytes.fromhex(publishable[1])]) == [
+        bytes.fromhex(publishable[0])
+    ]
+
+    watch.finalize_send(True, context, publishable[1])
+    harness.wait_for_unlock()
+    harness.return_funds(wallet, watch, 0)
@@ -1,10 +1,11 @@
 # Types.
-from typing import Dict, Any
+from typing import Dict, List, Optional, Any
 
 # Address class.
 from cryptonote.classes.wallet.address import Address
 
-# TurtlecoinCrypto class.
+# Crypto classes.
+from cryptonote.crypto.monero_crypto import RingCTType
 from cryptonote.crypto.turtlecoin_crypto import TurtlecoinCrypto
 
 # TurtlecoinRPC class.
@@ -13,6 +14,14 @@ from cryptonote.rpc.turtlecoin_rpc import TurtlecoinRPC
 # Wallet classes.
 from cryptonote.classes.wallet.wallet import WatchWallet, Wallet
 
+# Test the inherited signing state is initialized along with the network properties.
+def TRTL_crypto_test(turtlecoin_crypto: TurtlecoinCrypto):
+    assert turtlecoin_crypto.rct_type == RingCTType.CLSAG
+    assert turtlecoin_crypto.signer is not None
+    assert turtlecoin_crypto.network_byte_length == 4
+    assert turtlecoin_crypto.payment_id_lengths == {64}
+
+
 # Key generation test.
 def TRTL_key_generation(turtlecoin_crypto: TurtlecoinCrypto, constants: Dict[str, Any]):
     wallet: Wallet = Wallet(turtlecoin_crypto, constants["PRIVATE_SPEND_KEY"])
@@ -70,3 +79,23 @@ def TRTL_integrated_address_test(
     assert address == Address.parse(
         turtlecoin_crypto, constants["TRTL"]["INTEGRATED_ADDRESS"]
     )
+
+
+# Test parsing many addresses at once, with the leading payment ID and longer prefix.
+def TRTL_parse_many_test(
+    turtlecoin_crypto: TurtlecoinCrypto, constants: Dict[str, Any]
+):
+    parsed: List[Optional[Address]] = Address.parse_many(
+        turtlecoin_crypto,
+        [
+            constants["TRTL"]["INTEGRATED_ADDRESS"],
+            constants["TRTL"]["ADDRESS"],
+            constants["TRTL"]["ADDRESS"][:-1] + "1",
+        ],
+    )
+    assert parsed[0] is not None
+    assert parsed[0].payment_id == constants["TRTL"]["PAYMENT_ID"]
+    assert parsed[0].spend_key == constants["PUBLIC_SPEND_KEY"]
+    assert parsed[0].view_key == constants["PUBLIC_VIEW_KEY"]
+    assert parsed[1] == Address.parse(turtlecoin_crypto, constants["TRTL"]["ADDRESS"])
+    assert parsed[2] is None
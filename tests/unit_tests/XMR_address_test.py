@@ -1,8 +1,11 @@
 # Types.
-from typing import Dict, Any
+from typing import Dict, List, Optional, Any
 
-# Address class.
-from cryptonote.classes.wallet.address import Address
+# pytest lib.
+import pytest
+
+# Address classes.
+from cryptonote.classes.wallet.address import AddressError, Address
 
 # MoneroCrypto class.
 from cryptonote.crypto.monero_crypto import MoneroCrypto
@@ -88,3 +91,63 @@ def XMR_integrated_address_test(
     assert address == Address.parse(
         monero_payment_id_crypto, constants["XMR"]["INTEGRATED_ADDRESS"]
     )
+
+
+# Test parsing many addresses at once, including invalid ones.
+def XMR_parse_many_test(
+    monero_payment_id_crypto: MoneroCrypto, constants: Dict[str, Any]
+):
+    addresses: List[str] = [
+        constants["XMR"]["ADDRESS"],
+        constants["XMR"]["INTEGRATED_ADDRESS"],
+        # Invalid checksum.
+        constants["XMR"]["ADDRESS"][:-1] + "1",
+        # Invalid Base58.
+        "0" + constants["XMR"]["ADDRESS"][1:],
+        # Too short.
+        constants["XMR"]["ADDRESS"][:-11],
+        "",
+    ]
+    parsed: List[Optional[Address]] = Address.parse_many(
+        monero_payment_id_crypto, addresses
+    )
+    assert parsed[0] == Address.parse(monero_payment_id_crypto, addresses[0])
+    assert parsed[1] == Address.parse(monero_payment_id_crypto, addresses[1])
+    assert parsed[2:] == [None, None, None, None]
+
+    # Overriding the address with an invalid one raises the codec's error.
+    standard: Address = Address.parse(monero_payment_id_crypto, addresses[0])
+    with pytest.raises(AddressError):
+        Address(
+            monero_payment_id_crypto,
+            (standard.view_key, standard.spend_key),
+            None,
+            standard.network,
+            addresses[3],
+        )
+
+
+# Test generating a range of subaddresses at once.
+def XMR_new_addresses_test(monero_crypto: MoneroCrypto, constants: Dict[str, Any]):
+    watch: WatchWallet = WatchWallet(
+        monero_crypto,
+        MoneroRPC("", -1),
+        constants["PRIVATE_VIEW_KEY"],
+        constants["PUBLIC_SPEND_KEY"],
+        -1,
+    )
+
+    # Includes the standard address, (0, 0).
+    addresses: List[Address] = watch.new_addresses(0, 0, 300)
+    assert addresses[0].address == constants["XMR"]["ADDRESS"]
+    assert addresses[1].address == constants["XMR"]["SUBADDRESSES"][0][1]
+    assert addresses[256].address == constants["XMR"]["SUBADDRESSES"][1][1]
+    for minor in [0, 1, 2, 255, 299]:
+        assert addresses[minor] == watch.new_address((0, minor))
+        assert watch.unique_factors[addresses[minor].spend_key] == (0, minor)
+
+    # Another account, starting partway through.
+    addresses = watch.new_addresses(256, 1, 256)
+    assert addresses[0].address == constants["XMR"]["SUBADDRESSES"][2][1]
+    assert addresses[255].address == constants["XMR"]["SUBADDRESSES"][3][1]
+    assert watch.unique_factors[addresses[255].spend_key] == (256, 256)
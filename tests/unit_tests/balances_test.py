@@ -0,0 +1,116 @@
+# Types.
+from typing import Dict, List, Tuple, Any
+
+# urandom standard function.
+from os import urandom
+
+# randint standard function.
+from random import randint
+
+# OutputIndex class.
+from cryptonote.classes.blockchain import OutputIndex
+
+# Crypto classes.
+from cryptonote.crypto.crypto import InputState, OutputInfo
+from cryptonote.crypto.monero_crypto import MoneroCrypto, MoneroOutputInfo
+
+# Wallet classes.
+from cryptonote.classes.wallet.wallet import WatchWallet
+from cryptonote.classes.wallet.balances import Balance
+
+# RPC classes.
+from cryptonote.rpc.monero_rpc import MoneroRPC
+
+
+# Recompute a Balance by iterating over every output.
+def recompute(
+    watch: WatchWallet, height: int, subaddresses: List[Tuple[int, int]]
+) -> Balance:
+    result: Balance = Balance()
+    for index in watch.inputs:
+        output: OutputInfo = watch.inputs[index]
+        if output.subaddress not in subaddresses:  # type: ignore
+            continue
+        if output.state == InputState.Spendable:
+            if output.timelock >= height:
+                result.amounts[1] += output.amount
+            else:
+                result.amounts[0] += output.amount
+        elif output.state == InputState.Transmitted:
+            result.amounts[2] += output.amount
+    return result
+
+
+# Verify every Balance matches a recomputation.
+def verify(watch: WatchWallet, height: int) -> None:
+    every: List[Tuple[int, int]] = [
+        (major, minor) for major in range(2) for minor in range(3)
+    ]
+    assert watch.balance() == recompute(watch, height, every)
+    for subaddress in every:
+        assert watch.balance(subaddress) == recompute(watch, height, [subaddress])
+    for account in range(2):
+        assert watch.account_balance(account) == recompute(
+            watch, height, [(account, minor) for minor in range(3)]
+        )
+
+
+# Test the Balances stay correct as outputs are found, reserved, spent, and unlocked.
+def balances_test(monero_crypto: MoneroCrypto, constants: Dict[str, Any]) -> None:
+    watch: WatchWallet = WatchWallet(
+        monero_crypto,
+        MoneroRPC("", -1),
+        constants["PRIVATE_VIEW_KEY"],
+        constants["PUBLIC_SPEND_KEY"],
+        -1,
+    )
+    assert watch.balance() == Balance()
+    assert watch.account_balance(5) == Balance()
+
+    outputs: List[OutputInfo] = []
+    for _ in range(200):
+        outputs.append(
+            MoneroOutputInfo(
+                OutputIndex(urandom(32), 0),
+                randint(0, 40),
+                randint(1, 2 ** 40),
+                urandom(32),
+                (randint(0, 1), randint(0, 2)),
+                urandom(32),
+                urandom(32),
+            )
+        )
+        watch.inputs[outputs[-1].index] = outputs[-1]
+        watch.input_index.add(outputs[-1])
+        watch.balances.add(outputs[-1])
+    verify(watch, 0)
+
+    # Spend an output which is still locked.
+    locked: OutputInfo = watch.inputs[
+        [output.index for output in outputs if output.timelock > 20][0]
+    ]
+    with watch.reservation_lock:
+        watch.balances.set_state(locked, InputState.Spent)
+    verify(watch, 0)
+
+    for height in range(1, 45, 4):
+        watch.balances.advance(height)
+        verify(watch, height)
+
+        # Cycle between spending the inputs, releasing them, and letting them expire.
+        watch.reservation_timeout = 0 if height % 12 == 9 else 60
+        with watch.reservation_lock:
+            selected: List[OutputInfo] = watch.input_index.select(
+                lambda count: 2 ** 40, height
+            )
+            reservation: int = watch.reserve(selected)
+        verify(watch, height)
+
+        if height % 12 == 9:
+            with watch.reservation_lock:
+                watch.expire_reservations()
+        else:
+            watch.settle(
+                [output.index for output in selected], reservation, height % 12 == 1
+            )
+        verify(watch, height)
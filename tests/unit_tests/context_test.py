@@ -0,0 +1,85 @@
+# Types.
+from typing import Dict, List, Any
+
+# urandom standard function.
+from os import urandom
+
+# randint standard function.
+from random import randint
+
+# JSON standard lib.
+import json
+
+# Ed25519 lib.
+import cryptonote.lib.ed25519 as ed
+
+# OutputIndex class.
+from cryptonote.classes.blockchain import OutputIndex
+
+# Crypto classes.
+from cryptonote.crypto.crypto import SigningContext
+from cryptonote.crypto.monero_crypto import MoneroOutputInfo, MoneroCrypto
+
+# Wallet classes.
+from cryptonote.classes.wallet.wallet import Wallet, WatchWallet
+
+# MoneroRPC class.
+from cryptonote.rpc.monero_rpc import MoneroRPC
+
+
+# Test the binary context decodes to the same values as the JSON context, at under half the size.
+def binary_context_test(monero_crypto: MoneroCrypto, constants: Dict[str, Any]) -> None:
+    wallet: Wallet = Wallet(monero_crypto, constants["PRIVATE_SPEND_KEY"])
+    watch: WatchWallet = WatchWallet(
+        monero_crypto,
+        MoneroRPC("", -1),
+        wallet.private_view_key,
+        wallet.public_spend_key,
+        -1,
+    )
+
+    context: Dict[str, Any] = {
+        "inputs": [],
+        "mixins": [],
+        "ring": [],
+        "outputs": [
+            {"address": watch.new_address((0, 1)).address, "amount": 1000},
+            {"address": watch.new_address((0, 2)).address, "amount": 2 ** 64 - 1},
+        ],
+        "fee": randint(0, 2 ** 40),
+    }
+    for _ in range(50):
+        context["inputs"].append(
+            MoneroOutputInfo(
+                OutputIndex(urandom(32), randint(0, 15)),
+                randint(0, 2 ** 20),
+                randint(0, 2 ** 64 - 1),
+                urandom(32),
+                (randint(0, 2 ** 32 - 1), randint(0, 2 ** 32 - 1)),
+                ed.Hs(urandom(32)),
+                urandom(32),
+            ).to_json()
+        )
+        context["mixins"].append(sorted(set(randint(0, 2 ** 24) for _ in range(16))))
+        context["ring"].append(
+            [[urandom(32).hex(), urandom(32).hex()] for _ in context["mixins"][-1]]
+        )
+        context["inputs"][-1]["mixin_index"] = randint(
+            0, len(context["mixins"][-1]) - 1
+        )
+
+    binary: bytes = monero_crypto.encode_context(context)
+    assert len(binary) * 2 < len(json.dumps(context))
+
+    expected: SigningContext = wallet.parse_context(context)
+    for decoded in [
+        monero_crypto.decode_context(binary),
+        monero_crypto.decode_context(memoryview(bytearray(binary))),
+    ]:
+        assert decoded[1:] == expected[1:]
+        for i in range(len(expected[0])):
+            assert decoded[0][i] == expected[0][i]
+            assert decoded[0][i].index.index == expected[0][i].index.index
+            assert decoded[0][i].subaddress == expected[0][i].subaddress
+            assert decoded[0][i].amount_key == expected[0][i].amount_key
+            assert decoded[0][i].commitment == expected[0][i].commitment
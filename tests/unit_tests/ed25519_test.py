@@ -0,0 +1,95 @@
+# Types.
+from typing import Tuple
+
+# urandom standard function.
+from os import urandom
+
+# randint standard function.
+from random import randint
+
+# Ed25519 lib.
+import cryptonote.lib.ed25519 as ed
+
+
+# Double and add with the reference Python arithmetic.
+def reference_scalarmult(P: ed.CompressedPoint, e: int) -> ed.CompressedPoint:
+    result: ed.CompressedPoint = (0, 1)
+    for i in reversed(range(e.bit_length())):
+        result = ed.edwards(result, result)
+        if (e >> i) & 1:
+            result = ed.edwards(result, P)
+    return result
+
+
+# Test the native operations match the reference arithmetic.
+def ed25519_test() -> None:
+    for _ in range(4):
+        scalar: bytes = ed.Hs(urandom(32))
+        other: bytes = ed.Hs(urandom(32))
+        point: bytes = ed.public_from_secret(other)
+
+        # Hs.
+        data: bytes = urandom(64)
+        assert ed.Hs(data) == ed.encodeint(ed.decodeint(ed.H(data)) % ed.l)
+
+        # Encoding round trips.
+        assert ed.encodeint(ed.decodeint(scalar)) == scalar
+        assert ed.encodepoint(ed.decodepoint(point)) == point
+
+        # sG and sP.
+        assert ed.public_from_secret(scalar) == ed.encodepoint(
+            reference_scalarmult(ed.B, ed.decodeint(scalar))
+        )
+        assert ed.scalarmult_key(point, scalar) == ed.encodepoint(
+            reference_scalarmult(ed.decodepoint(point), ed.decodeint(scalar))
+        )
+        assert ed.scalarmult(ed.decodepoint(point), ed.decodeint(scalar)) == (
+            reference_scalarmult(ed.decodepoint(point), ed.decodeint(scalar))
+        )
+
+        # 8aR.
+        assert ed.generate_key_derivation(point, scalar) == ed.encodepoint(
+            reference_scalarmult(ed.decodepoint(point), 8 * ed.decodeint(scalar))
+        )
+
+        # Addition and subtraction.
+        scalar_G: bytes = ed.public_from_secret(scalar)
+        added: bytes = ed.add_keys(point, scalar_G)
+        assert added == ed.encodepoint(
+            ed.edwards(ed.decodepoint(point), ed.decodepoint(scalar_G))
+        )
+        assert ed.sub_keys(added, scalar_G) == point
+
+        # Commitments.
+        amount: int = randint(0, 2 ** 64 - 1)
+        assert ed.commit(amount, scalar) == ed.encodepoint(
+            ed.edwards(
+                reference_scalarmult(ed.B, ed.decodeint(scalar)),
+                reference_scalarmult(ed.C, amount),
+            )
+        )
+
+        # Subaddresses.
+        index: Tuple[int, int] = (randint(0, 2 ** 32 - 1), randint(1, 2 ** 32 - 1))
+        spend_key: ed.CompressedPoint = ed.edwards(
+            ed.decodepoint(point),
+            reference_scalarmult(
+                ed.B,
+                ed.decodeint(
+                    ed.Hs(
+                        b"SubAddr\0"
+                        + scalar
+                        + index[0].to_bytes(4, byteorder="little")
+                        + index[1].to_bytes(4, byteorder="little")
+                    )
+                ),
+            ),
+        )
+        assert ed.generate_subaddress_key_pair(scalar, point, index) == (
+            ed.encodepoint(reference_scalarmult(spend_key, ed.decodeint(scalar))),
+            ed.encodepoint(spend_key),
+        )
+        assert ed.generate_subaddress_key_pair(scalar, point, (0, 0)) == (
+            ed.public_from_secret(scalar),
+            point,
+        )
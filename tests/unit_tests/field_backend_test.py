@@ -0,0 +1,81 @@
+# Types.
+from typing import Tuple
+
+# urandom standard function.
+from os import urandom
+
+# randint standard function.
+from random import randint
+
+# pytest lib.
+import pytest
+
+# Ed25519 lib. Its point arithmetic is pure Python, independent of the native backend.
+import cryptonote.lib.ed25519 as ed
+
+# Field backend function.
+from cryptonote.lib.monero_rct.c_monero_rct import field_backend
+
+# Encoding of y = 2, which isn't on the curve.
+INVALID_POINT: bytes = (2).to_bytes(32, byteorder="little")
+
+# Identity in extended coordinates.
+IDENTITY: Tuple[int, int, int, int] = (0, 1, 1, 0)
+
+
+# eP, by double and add in extended coordinates.
+def reference_scalarmult(P: ed.CompressedPoint, e: int) -> ed.CompressedPoint:
+    result: ed.UncompressedPoint = IDENTITY
+    addend: ed.UncompressedPoint = ed.decompress(P)
+    while e != 0:
+        if e & 1:
+            result = tuple(c % ed.q for c in ed.add(result, addend))  # type: ignore
+        addend = tuple(c % ed.q for c in ed.add(addend, addend))  # type: ignore
+        e >>= 1
+    return ed.compress(result)
+
+
+# Test the active field backend against the pure Python arithmetic.
+def field_backend_test() -> None:
+    assert field_backend() in ["radix-51", "ref10"]
+
+    for i in range(32):
+        scalar: bytes = ed.Hs(urandom(32))
+        e: int = ed.decodeint(scalar)
+        P_bytes: bytes = ed.public_from_secret(ed.Hs(urandom(32)))
+        Q_bytes: bytes = ed.public_from_secret(ed.Hs(urandom(32)))
+        P: ed.CompressedPoint = ed.decodepoint(P_bytes)
+        Q: ed.CompressedPoint = ed.decodepoint(Q_bytes)
+
+        assert ed.scalarmult_base(scalar) == ed.encodepoint(
+            reference_scalarmult(ed.B, e)
+        )
+        assert ed.scalarmult_key(P_bytes, scalar) == ed.encodepoint(
+            reference_scalarmult(P, e)
+        )
+        assert ed.generate_key_derivation(P_bytes, scalar) == ed.encodepoint(
+            reference_scalarmult(P, 8 * e)
+        )
+        assert ed.add_keys(P_bytes, Q_bytes) == ed.encodepoint(ed.edwards(P, Q))
+        assert ed.sub_keys(P_bytes, Q_bytes) == ed.encodepoint(
+            ed.edwards(P, ((-Q[0]) % ed.q, Q[1]))
+        )
+
+        # Commitments, including the largest amount.
+        amount: int = 2 ** 64 - 1 if i == 0 else randint(0, 2 ** 64 - 1)
+        assert ed.commit(amount, scalar) == ed.encodepoint(
+            ed.edwards(
+                reference_scalarmult(ed.B, e), reference_scalarmult(ed.C, amount)
+            )
+        )
+
+    # Invalid points are rejected.
+    scalar = ed.Hs(urandom(32))
+    for operation in [
+        lambda: ed.scalarmult_key(INVALID_POINT, scalar),
+        lambda: ed.generate_key_derivation(INVALID_POINT, scalar),
+        lambda: ed.add_keys(INVALID_POINT, ed.public_from_secret(scalar)),
+        lambda: ed.sub_keys(ed.public_from_secret(scalar), INVALID_POINT),
+    ]:
+        with pytest.raises(ValueError, match="Key isn't a valid point."):
+            operation()
@@ -0,0 +1,90 @@
+# Types.
+from typing import Callable, List
+
+# urandom standard function.
+from os import urandom
+
+# OutputIndex class.
+from cryptonote.classes.blockchain import OutputIndex
+
+# Crypto classes.
+from cryptonote.crypto.crypto import InputState, OutputInfo
+
+# InputIndex class.
+from cryptonote.classes.wallet.input_index import IndexKey, InputIndex
+
+
+def output(amount: int, timelock: int = 0) -> OutputInfo:
+    return OutputInfo(OutputIndex(urandom(32), 0), timelock, amount, urandom(32))
+
+
+# Test the selection strategies.
+def select_test() -> None:
+    outputs: List[OutputInfo] = [output(amount) for amount in [1, 5, 10, 20, 50]]
+    index: InputIndex = InputIndex(outputs)
+
+    # The smallest single output which covers the amount is preferred.
+    assert index.select(lambda count: 12, 1) == [outputs[3]]
+
+    # Else, the fewest inputs, with the last one best fit.
+    assert index.select(lambda count: 55 + count, 1) == [outputs[4], outputs[2]]
+
+    # Reserved and spent outputs leave the index.
+    outputs[4].state = InputState.Transmitted
+    outputs[3].state = InputState.Spent
+    index.update(outputs[4])
+    index.update(outputs[3])
+    assert index.select(lambda count: 17, 1) == []
+    assert index.select(lambda count: 11, 1) == [outputs[2], outputs[0]]
+    assert len(index) == 3
+
+    # Released reservations return.
+    outputs[4].state = InputState.Spendable
+    index.update(outputs[4])
+    assert index.select(lambda count: 17, 1) == [outputs[4]]
+    assert len(index) == 4
+
+    # Locked and dust outputs are skipped, until the lock passes.
+    locked: OutputInfo = output(100, 10)
+    index.add(locked)
+    assert index.select(lambda count: 100, 10) == []
+    assert index.select(lambda count: 6, 1, 6) == [outputs[2]]
+    assert index.select(lambda count: 100, 11) == [locked]
+    assert len(index) == 5
+
+    # Dust is listed largest first.
+    assert index.below(10, 1) == [outputs[1], outputs[0]]
+
+
+# Test selection only looks up the outputs it selects, out of many.
+def select_speed_test() -> None:
+    index: InputIndex = InputIndex(
+        [output(int.from_bytes(urandom(4), byteorder="little")) for _ in range(100000)]
+    )
+
+    # Reserve most outputs. They leave the index instead of being stepped over.
+    keys: List[IndexKey] = index.keys()
+    for k in range(len(keys)):
+        if k % 100 == 0:
+            continue
+        reserved: OutputInfo = index.output(keys[k])
+        reserved.state = InputState.Transmitted
+        index.update(reserved)
+    assert len(index) == 1000
+
+    # Count the outputs looked up instead of timing, which varies with the host.
+    examined: List[int] = [0]
+    lookup: Callable[[IndexKey], OutputInfo] = index.output
+
+    def counted(k: IndexKey) -> OutputInfo:
+        examined[0] += 1
+        return lookup(k)
+
+    index.output = counted  # type: ignore
+
+    for _ in range(100):
+        examined[0] = 0
+        selected: List[OutputInfo] = index.select(lambda count: 2 ** 34, 1)
+        assert selected
+        assert examined[0] == len(selected)
+        assert all(input_i.state == InputState.Spendable for input_i in selected)
@@ -0,0 +1,122 @@
+# Types.
+from typing import Dict, List, Tuple, Any
+
+# urandom standard function.
+from os import urandom
+
+# randint standard function.
+from random import randint
+
+# Ed25519 lib.
+import cryptonote.lib.ed25519 as ed
+
+# Batched input key function.
+from cryptonote.lib.monero_rct.c_monero_rct import generate_input_keys_many
+
+# OutputIndex class.
+from cryptonote.classes.blockchain import OutputIndex
+
+# Crypto classes.
+from cryptonote.crypto.crypto import OutputInfo
+from cryptonote.crypto.monero_crypto import MoneroOutputInfo, MoneroCrypto
+from cryptonote.crypto.monero_payment_id_crypto import MoneroPaymentIDCrypto
+
+
+def random_outputs() -> List[OutputInfo]:
+    subaddresses: List[Tuple[int, int]] = [(0, 0), (0, 1), (1, 0), (256, 256)]
+    outputs: List[OutputInfo] = []
+    for _ in range(8):
+        outputs.append(
+            MoneroOutputInfo(
+                OutputIndex(urandom(32), randint(0, 15)),
+                0,
+                randint(0, 2 ** 64 - 1),
+                urandom(32),
+                subaddresses[randint(0, len(subaddresses) - 1)],
+                ed.Hs(urandom(32)),
+                ed.Hs(urandom(32)),
+            )
+        )
+    return outputs
+
+
+# Test the batched key images match the per-output key images.
+def batch_key_images_test(
+    monero_crypto: MoneroCrypto,
+    monero_payment_id_crypto: MoneroPaymentIDCrypto,
+    constants: Dict[str, Any],
+) -> None:
+    for crypto in [monero_crypto, monero_payment_id_crypto]:
+        outputs: List[OutputInfo] = random_outputs()
+        assert crypto.generate_key_images(
+            outputs, constants["PRIVATE_VIEW_KEY"], constants["PRIVATE_SPEND_KEY"]
+        ) == [
+            crypto.generate_key_image(
+                output, constants["PRIVATE_VIEW_KEY"], constants["PRIVATE_SPEND_KEY"]
+            )
+            for output in outputs
+        ]
+
+
+# Test the native one-time keys match the reference formula, with and without a cache.
+def input_key_test(monero_crypto: MoneroCrypto, constants: Dict[str, Any]) -> None:
+    cache: Dict[Tuple[int, int], bytes] = {}
+    for output in random_outputs():
+        if not isinstance(output, MoneroOutputInfo):
+            raise Exception("Random outputs weren't MoneroOutputInfos.")
+
+        expected: bytes = ed.encodeint(
+            (
+                ed.decodeint(output.amount_key)
+                + ed.generate_subaddress_private_spend_key(
+                    constants["PRIVATE_VIEW_KEY"],
+                    constants["PRIVATE_SPEND_KEY"],
+                    output.subaddress,
+                )
+            )
+            % ed.l
+        )
+        for subaddress_keys in [None, cache, cache]:
+            assert (
+                monero_crypto.generate_input_key(
+                    output,
+                    constants["PRIVATE_VIEW_KEY"],
+                    constants["PRIVATE_SPEND_KEY"],
+                    subaddress_keys,
+                )
+                == expected
+            )
+        assert output.subaddress in cache
+
+
+# Test the batched one-time keys and key images used to sign match the per-output ones.
+def batch_input_keys_test(
+    monero_crypto: MoneroCrypto, constants: Dict[str, Any]
+) -> None:
+    outputs: List[OutputInfo] = random_outputs()
+    inputs: List[Tuple[bytes, bytes]] = []
+    for output in outputs:
+        if not isinstance(output, MoneroOutputInfo):
+            raise Exception("Random outputs weren't MoneroOutputInfos.")
+        inputs.append(
+            (
+                output.amount_key,
+                monero_crypto.generate_subaddress_private_spend_key(
+                    constants["PRIVATE_VIEW_KEY"],
+                    constants["PRIVATE_SPEND_KEY"],
+                    output.subaddress,
+                ),
+            )
+        )
+
+    assert generate_input_keys_many(inputs, 3) == [
+        (
+            monero_crypto.generate_input_key(
+                output, constants["PRIVATE_VIEW_KEY"], constants["PRIVATE_SPEND_KEY"]
+            ),
+            monero_crypto.generate_key_image(
+                output, constants["PRIVATE_VIEW_KEY"], constants["PRIVATE_SPEND_KEY"]
+            ),
+        )
+        for output in outputs
+    ]
@@ -0,0 +1,99 @@
+# Types.
+from typing import List
+
+# urandom standard function.
+from os import urandom
+
+# randint standard function.
+from random import randint
+
+# pytest lib.
+import pytest
+
+# OutputIndex class.
+from cryptonote.classes.blockchain import OutputIndex
+
+# Crypto classes.
+from cryptonote.crypto.crypto import InputState, OutputInfo
+from cryptonote.crypto.monero_crypto import MoneroOutputInfo
+
+# StoredOutputs class.
+from cryptonote.classes.wallet.output_store import StoredOutputs
+
+# InputIndex class.
+from cryptonote.classes.wallet.input_index import InputIndex
+
+
+def output() -> MoneroOutputInfo:
+    return MoneroOutputInfo(
+        OutputIndex(urandom(32), randint(0, 15)),
+        randint(0, 2 ** 64 - 1),
+        randint(0, 2 ** 64 - 1),
+        urandom(32),
+        (randint(0, 2 ** 32 - 1), randint(0, 2 ** 32 - 1)),
+        urandom(32),
+        urandom(32),
+    )
+
+
+# Test outputs round trip through the store.
+def output_store_test() -> None:
+    outputs: List[MoneroOutputInfo] = [output() for _ in range(1000)]
+    outputs[0].state = InputState.Transmitted
+    stored: StoredOutputs = StoredOutputs()
+    for output_i in outputs:
+        stored[output_i.index] = output_i
+
+    # Lookups return views equal to the stored outputs, in insertion order.
+    assert len(stored) == len(outputs)
+    assert list(stored) == [output_i.index for output_i in outputs]
+    for output_i in outputs:
+        assert output_i.index in stored
+        assert isinstance(stored[output_i.index], MoneroOutputInfo)
+        assert stored[output_i.index] == output_i
+        assert stored[output_i.index].to_json() == output_i.to_json()
+    assert OutputIndex(urandom(32), 0) not in stored
+
+    # State changes are written back to the store.
+    view: OutputInfo = stored[outputs[1].index]
+    view.state = InputState.Spent
+    assert stored[outputs[1].index].state == InputState.Spent
+
+    # Outputs can't be replaced.
+    with pytest.raises(Exception, match="Output is already stored."):
+        stored[outputs[2].index] = outputs[2]
+
+    # Outputs without Monero's fields are viewed without them, beside Monero outputs.
+    plain: OutputInfo = OutputInfo(OutputIndex(urandom(32), 0), 0, 1, urandom(32))
+    stored[plain.index] = plain
+    assert not isinstance(stored[plain.index], MoneroOutputInfo)
+    assert stored[plain.index] == plain
+    assert isinstance(stored[outputs[0].index], MoneroOutputInfo)
+
+    # Records stay fixed-width.
+    assert stored.store.allocated < len(outputs) * 256
+
+
+# Test an InputIndex backed by the store.
+def stored_input_index_test() -> None:
+    stored: StoredOutputs = StoredOutputs()
+    index: InputIndex = InputIndex(store=stored)
+    outputs: List[OutputInfo] = [
+        OutputInfo(OutputIndex(urandom(32), 0), 0, amount, urandom(32))
+        for amount in [1, 5, 10, 20, 50]
+    ]
+    for output_i in outputs:
+        stored[output_i.index] = output_i
+        index.add(output_i)
+        index.add(stored[output_i.index])
+    assert len(index) == len(outputs)
+
+    assert index.select(lambda count: 12, 1) == [outputs[3]]
+    stored[outputs[3].index].state = InputState.Spent
+    index.update(stored[outputs[3].index])
+    assert index.select(lambda count: 12, 1) == [outputs[4]]
+    assert len(index) == 4
+
+    index.remove(outputs[4].index)
+    assert len(index) == 3
+    assert outputs[4].index in stored
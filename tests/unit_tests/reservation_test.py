@@ -0,0 +1,150 @@
+# Types.
+from typing import Dict, List, Tuple, Any
+
+# urandom standard function.
+from os import urandom
+
+# Thread standard class.
+from threading import Thread
+
+# pytest lib.
+import pytest
+
+# Blockchain classes.
+from cryptonote.classes.blockchain import OutputIndex, BlockHeader, Block
+
+# Crypto classes.
+from cryptonote.crypto.crypto import InputState, OutputInfo
+from cryptonote.crypto.monero_crypto import MoneroCrypto
+
+# Wallet classes.
+from cryptonote.classes.wallet.address import Address
+from cryptonote.classes.wallet.wallet import BalanceError, WatchWallet
+
+# RPC classes.
+from cryptonote.rpc.monero_rpc import MoneroRPC
+
+# Amount of each output, and what each send spends of one.
+AMOUNT: int = 10 ** 12
+SEND: int = 10 ** 11
+FEE: int = 10 ** 10
+
+
+class ChainRPC(MoneroRPC):
+    """RPC of a chain with enough outputs to pick mixins from, and the lowest fee."""
+
+    def __init__(self) -> None:
+        MoneroRPC.__init__(self, "", -1)
+
+    def get_block_count(self) -> int:
+        return 1000
+
+    def get_block_hash(self, height: int) -> bytes:
+        return bytes(32)
+
+    def get_block(self, block_hash: bytes) -> Block:
+        return Block(
+            BlockHeader(
+                {
+                    "hash": block_hash.hex(),
+                    "height": 940,
+                    "depth": 60,
+                    "prev_hash": bytes(32).hex(),
+                    "timestamp": 0,
+                    "orphan_status": False,
+                    "cumulative_difficulty": 1,
+                    "difficulty": 1,
+                    "miner_tx_hash": bytes(32).hex(),
+                    "num_txes": 0,
+                }
+            ),
+            {"tx_hashes": []},
+        )
+
+    def get_o_indexes(self, tx_hash: bytes) -> List[int]:
+        return [30000000]
+
+    def get_outs_many(self, indexes: List[int]) -> List[Dict[str, Any]]:
+        return [{"key": urandom(32), "mask": urandom(32)} for _ in indexes]
+
+    def get_fee_estimate(self) -> Tuple[int, int]:
+        return (1, 1)
+
+
+def new_watch(
+    monero_crypto: MoneroCrypto, constants: Dict[str, Any], outputs: int
+) -> WatchWallet:
+    watch: WatchWallet = WatchWallet(
+        monero_crypto,
+        ChainRPC(),
+        constants["PRIVATE_VIEW_KEY"],
+        constants["PUBLIC_SPEND_KEY"],
+        -1,
+    )
+    for _ in range(outputs):
+        output: OutputInfo = OutputInfo(
+            OutputIndex(urandom(32), 0), 0, AMOUNT, urandom(32)
+        )
+        watch.inputs[output.index] = output
+        watch.input_index.add(output)
+        watch.balances.add(output)
+    watch.balances.advance(1)
+    return watch
+
+
+def send(watch: WatchWallet, dest: Address, contexts: List[Dict[str, Any]]) -> None:
+    for _ in range(8):
+        contexts.append(watch.prepare_send(dest, SEND, FEE))
+
+
+# Test concurrent sends never reserve the same input.
+def concurrent_reservation_test(
+    monero_crypto: MoneroCrypto, constants: Dict[str, Any]
+) -> None:
+    watch: WatchWallet = new_watch(monero_crypto, constants, 64)
+    dest: Address = watch.new_address((0, 1))
+
+    contexts: List[Dict[str, Any]] = []
+    threads: List[Thread] = [
+        Thread(target=send, args=(watch, dest, contexts)) for _ in range(8)
+    ]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+
+    claimed: List[OutputIndex] = [
+        index for context in contexts for index in WatchWallet.context_inputs(context)
+    ]
+    assert len(claimed) == 64
+    assert len(set(claimed)) == 64
+    assert len({context["reservation"] for context in contexts}) == 64
+    with pytest.raises(BalanceError):
+        watch.prepare_send(dest, SEND, FEE)
+
+
+# Test reservations expire and expired sends don't release reinstated reservations.
+def reservation_expiry_test(
+    monero_crypto: MoneroCrypto, constants: Dict[str, Any]
+) -> None:
+    watch: WatchWallet = new_watch(monero_crypto, constants, 1)
+    dest: Address = watch.new_address((0, 1))
+    output: OutputInfo = list(watch.inputs.values())[0]
+
+    watch.reservation_timeout = 0
+    expired: Dict[str, Any] = watch.prepare_send(dest, SEND, FEE)
+    assert watch.inputs[output.index].state == InputState.Transmitted
+    with watch.reservation_lock:
+        watch.expire_reservations()
+    assert watch.inputs[output.index].state == InputState.Spendable
+
+    # The next send reserves the input again, as the first send's reservation expired.
+    watch.reservation_timeout = 60
+    current: Dict[str, Any] = watch.prepare_send(dest, SEND, FEE)
+    assert WatchWallet.context_inputs(current) == [output.index]
+
+    watch.settle(WatchWallet.context_inputs(expired), expired["reservation"], False)
+    assert watch.inputs[output.index].state == InputState.Transmitted
+    watch.settle(WatchWallet.context_inputs(current), current["reservation"], False)
+    assert watch.inputs[output.index].state == InputState.Spendable
+    assert not watch.reservations
@@ -0,0 +1,68 @@
+# Types.
+from typing import List, Tuple
+
+# urandom standard function.
+from os import urandom
+
+# randint standard function.
+from random import randint
+
+# pytest lib.
+import pytest
+
+# Ed25519 lib.
+import cryptonote.lib.ed25519 as ed
+
+# VarInt lib.
+from cryptonote.lib.var_int import to_var_int
+
+# Scanning and backend functions.
+from cryptonote.lib.monero_rct.c_monero_rct import scan_transactions, vector_backend
+
+
+# Encoding of y = 2, which isn't on the curve.
+INVALID_POINT: bytes = (2).to_bytes(32, byteorder="little")
+
+
+# Test batched scanning matches deriving each key individually.
+# Includes a low order R and Transaction sizes which leave partial groups.
+def scan_test() -> None:
+    assert vector_backend() in ["avx2", "scalar"]
+
+    view_key: bytes = ed.Hs(urandom(32))
+    txs: List[Tuple[List[bytes], List[bytes]]] = []
+    for _ in range(9):
+        Rs: List[bytes] = [
+            ed.public_from_secret(ed.Hs(urandom(32))) for _ in range(randint(1, 3))
+        ]
+        outputs: List[bytes] = [
+            ed.public_from_secret(ed.Hs(urandom(32))) for _ in range(randint(1, 5))
+        ]
+        txs.append((Rs, outputs))
+    # A point of order 8, which only derives the identity if the cofactor is applied.
+    txs[0][0].append(
+        bytes.fromhex("c7176a703d4dd84fba3c0b760d10670f2a2053fa2c39ccc64ec7fd7792ac037a")
+    )
+
+    # Both the constant time and variable time derivations.
+    for variable_time in [False, True]:
+        for tx, scanned in zip(txs, scan_transactions(view_key, txs, 2, variable_time)):
+            assert len(scanned[0]) == len(tx[0])
+            for r, R in enumerate(tx[0]):
+                expected: bytes = ed.generate_key_derivation(R, view_key)
+                assert scanned[0][r] == expected
+
+                assert len(scanned[1][r]) == len(tx[1])
+                for o, key in enumerate(tx[1]):
+                    assert scanned[1][r][o] == ed.sub_keys(
+                        key, ed.scalarmult_base(ed.Hs(expected + to_var_int(o)))
+                    )
+
+        # Invalid Rs and output keys raise, as deriving them one at a time does.
+        for invalid in [
+            txs[:4] + [(txs[4][0] + [INVALID_POINT], txs[4][1])],
+            txs[:4] + [(txs[4][0], txs[4][1] + [INVALID_POINT])],
+            [([urandom(31)], txs[0][1])],
+        ]:
+            with pytest.raises(ValueError, match="Key isn't a valid point."):
+                scan_transactions(view_key, invalid, 2, variable_time)
@@ -0,0 +1,205 @@
+# Types.
+from typing import Dict, List, Tuple, Any
+
+# urandom standard function.
+from os import urandom
+
+# randint and sample standard functions.
+from random import randint, sample
+
+# Ed25519 lib.
+import cryptonote.lib.ed25519 as ed
+
+# VarInt lib.
+from cryptonote.lib.var_int import to_var_int
+
+# Serialization and weight functions.
+from cryptonote.lib.monero_rct.c_monero_rct import (
+    serialize_transaction_prefix,
+    get_transaction_hashes,
+    get_transaction_weight,
+)
+
+# OutputIndex class.
+from cryptonote.classes.blockchain import OutputIndex
+
+# Crypto classes.
+from cryptonote.crypto.crypto import SpendableOutput
+from cryptonote.crypto.monero_crypto import (
+    RingCTType,
+    MoneroOutputInfo,
+    MoneroSpendableTransaction,
+    MoneroCrypto,
+)
+
+# Mainnet's genesis miner Transaction, as Monero's config embeds it, and its hash.
+GENESIS_TX: bytes = bytes.fromhex(
+    "013c01ff0001ffffffffffff03029b2e4c0281c0b02e7c53291a94d1d0cbff8883f8024f5142ee49"
+    + "4ffbbd08807121017767aafcde9be00dcfd098715ebcf7f410daebc582fda69d24a28e9d0bc890d1"
+)
+GENESIS_TX_HASH: bytes = bytes.fromhex(
+    "c88ce9783b4f11190d7b9c17a69c1c52200f9faaee8e98dd07e6811175177139"
+)
+
+
+# Test the native prefix serialization matches the Transaction format.
+def prefix_test() -> None:
+    inputs: List[Tuple[List[int], bytes]] = [
+        ([randint(0, 2 ** 32) for _ in range(16)], urandom(32)) for _ in range(3)
+    ]
+    output_keys: List[bytes] = [urandom(32), urandom(32)]
+    view_tags: bytes = urandom(2)
+    extra: bytes = bytes([0x01]) + urandom(32)
+
+    expected: bytes = bytes([2, 0]) + to_var_int(len(inputs))
+    for input_i in inputs:
+        expected += bytes([2, 0]) + to_var_int(len(input_i[0]))
+        for offset in input_i[0]:
+            expected += to_var_int(offset)
+        expected += input_i[1]
+    expected += to_var_int(len(output_keys))
+    for o, key in enumerate(output_keys):
+        expected += bytes([0, 3]) + key + view_tags[o : o + 1]
+    expected += to_var_int(len(extra)) + extra
+
+    assert serialize_transaction_prefix(inputs, output_keys, view_tags, extra) == (
+        ed.H(expected),
+        expected,
+    )
+
+
+# Test hashing a mainnet Transaction. Version 1 Transactions are hashed as a whole.
+def mainnet_tx_hash_test() -> None:
+    assert ed.H(GENESIS_TX) == GENESIS_TX_HASH
+    assert get_transaction_hashes([GENESIS_TX]) == [GENESIS_TX_HASH]
+
+
+# Sign a Transaction spending one input to the main address, with change to it.
+def signed_transaction(
+    crypto: MoneroCrypto, constants: Dict[str, Any]
+) -> Tuple[MoneroSpendableTransaction, List[int], List[List[bytes]]]:
+    private_view_key: bytes = constants["PRIVATE_VIEW_KEY"]
+    private_spend_key: bytes = constants["PRIVATE_SPEND_KEY"]
+
+    # Input owned by the main address, at a random position in its ring.
+    amount: int = randint(2 ** 30, 2 ** 40)
+    mask: bytes = ed.Hs(urandom(32))
+    input_i: MoneroOutputInfo = MoneroOutputInfo(
+        OutputIndex(urandom(32), randint(0, 15)),
+        0,
+        amount,
+        constants["PUBLIC_SPEND_KEY"],
+        (0, 0),
+        ed.Hs(urandom(32)),
+        mask,
+    )
+    mixins: List[int] = sorted(sample(range(2 ** 24), 16))
+    ring: List[List[bytes]] = [
+        [
+            ed.public_from_secret(ed.Hs(urandom(32))),
+            ed.commit(randint(0, 2 ** 40), ed.Hs(urandom(32))),
+        ]
+        for _ in mixins
+    ]
+    ring[input_i.index.index] = [
+        ed.public_from_secret(
+            crypto.generate_input_key(input_i, private_view_key, private_spend_key)
+        ),
+        ed.commit(amount, mask),
+    ]
+
+    tx: MoneroSpendableTransaction = crypto.spendable_transaction(
+        [input_i],
+        [mixins],
+        [
+            SpendableOutput(
+                crypto.network_bytes[0],
+                constants["PUBLIC_VIEW_KEY"],
+                constants["PUBLIC_SPEND_KEY"],
+                None,
+                amount // 2,
+            )
+        ],
+        [ring],
+        SpendableOutput(
+            crypto.network_bytes[0],
+            constants["PUBLIC_VIEW_KEY"],
+            constants["PUBLIC_SPEND_KEY"],
+            None,
+            0,
+        ),
+        10 ** 8,
+    )
+    crypto.sign(tx, private_view_key, private_spend_key)
+    return (tx, mixins, ring)
+
+
+# Test the default RingCT type leaves outputs untagged. Tags require BulletproofPlus.
+def default_type_test(monero_crypto: MoneroCrypto, constants: Dict[str, Any]) -> None:
+    assert monero_crypto.rct_type == RingCTType.CLSAG
+    tx, mixins, ring = signed_transaction(monero_crypto, constants)
+    tx_hash, blob = tx.serialize()
+
+    # Every output is a txout_to_key, without a view tag.
+    assert tx.view_tags == bytes()
+    prefix: bytes = serialize_transaction_prefix(
+        [(input_j.mixins, input_j.image) for input_j in tx.inputs],
+        tx.output_keys,
+        tx.view_tags,
+        tx.extra,
+    )[1]
+    assert blob[: len(prefix)] == prefix
+    for key in tx.output_keys:
+        assert bytes([0, 2]) + key in prefix
+        assert bytes([0, 3]) + key not in prefix
+    assert blob[len(prefix)] == RingCTType.CLSAG.value
+
+    # Two outputs have no clawback, so the weight is the serialized length.
+    assert len(tx.output_keys) == 2
+    assert get_transaction_weight(
+        [mixins], 2, len(tx.extra), tx.fee, RingCTType.CLSAG.value
+    ) == len(blob)
+
+    assert get_transaction_hashes([blob]) == [tx_hash]
+    assert monero_crypto.verify_transactions(
+        [(blob, {mixins[m]: (ring[m][0], ring[m][1]) for m in range(len(mixins))})]
+    ) == [True]
+
+
+# Test a signed BulletproofPlus Transaction with view tags survives serialization.
+def view_tag_test(constants: Dict[str, Any]) -> None:
+    crypto: MoneroCrypto = MoneroCrypto(rct_type=RingCTType.BulletproofPlus)
+    private_view_key: bytes = constants["PRIVATE_VIEW_KEY"]
+    tx, mixins, ring = signed_transaction(crypto, constants)
+    tx_hash, blob = tx.serialize()
+
+    # Every output is tagged with the view tag its recipient derives.
+    shared_key: bytes = crypto.create_shared_key(private_view_key, tx.extra[1:33])
+    assert len(tx.view_tags) == len(tx.output_keys)
+    for o, key in enumerate(tx.output_keys):
+        assert tx.view_tags[o] == ed.H(b"view_tag" + shared_key + to_var_int(o))[0]
+        assert bytes([0, 3]) + key + tx.view_tags[o : o + 1] in blob
+
+    # Version 2 Transactions are hashed as H(H(prefix) || H(base) || H(prunable)).
+    # The base is the type, fee, encrypted amounts, and output commitments.
+    prefix: bytes = serialize_transaction_prefix(
+        [(input_j.mixins, input_j.image) for input_j in tx.inputs],
+        tx.output_keys,
+        tx.view_tags,
+        tx.extra,
+    )[1]
+    assert blob[: len(prefix)] == prefix
+    base_end: int = (
+        len(prefix) + 1 + len(to_var_int(tx.fee)) + (40 * len(tx.output_keys))
+    )
+    assert blob[len(prefix)] == RingCTType.BulletproofPlus.value
+    assert tx_hash == ed.H(
+        ed.H(prefix) + ed.H(blob[len(prefix) : base_end]) + ed.H(blob[base_end:])
+    )
+
+    # The serialization parses back to the same hash and verifies.
+    assert tx.hash == tx_hash
+    assert get_transaction_hashes([blob]) == [tx_hash]
+    assert crypto.verify_transactions(
+        [(blob, {mixins[m]: (ring[m][0], ring[m][1]) for m in range(len(mixins))})]
+    ) == [True]
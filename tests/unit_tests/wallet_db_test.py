@@ -0,0 +1,176 @@
+# Types.
+from typing import Dict, List, Any
+
+# urandom standard function.
+from os import urandom
+
+# randint standard function.
+from random import randint
+
+# Path standard class.
+from pathlib import Path
+
+# OutputIndex class.
+from cryptonote.classes.blockchain import OutputIndex
+
+# Native wallet database.
+from cryptonote.lib.monero_rct.c_monero_rct import WalletDB
+
+# Crypto classes.
+from cryptonote.crypto.crypto import InputState, OutputInfo
+from cryptonote.crypto.monero_crypto import MoneroCrypto, MoneroOutputInfo
+
+# Wallet classes.
+from cryptonote.classes.wallet.wallet import REORG_RESCAN_DEPTH, WatchWallet
+from cryptonote.classes.wallet.balances import Balance
+from cryptonote.classes.wallet.input_index import InputIndex
+
+# RPC classes.
+from cryptonote.rpc.monero_rpc import MoneroRPC
+
+
+class CheckpointRPC(MoneroRPC):
+    """RPC whose chain ends at the Block a database was checkpointed at."""
+
+    def __init__(self, height: int, block_hash: bytes) -> None:
+        MoneroRPC.__init__(self, "", -1)
+        self.height: int = height
+        self.block_hash: bytes = block_hash
+
+    def get_block_count(self) -> int:
+        return self.height + 1
+
+    def get_block_hash(self, height: int) -> bytes:
+        assert height == self.height
+        return self.block_hash
+
+
+# Test a WatchWallet reloaded from its database matches the WatchWallet which wrote it.
+def wallet_db_test(
+    monero_crypto: MoneroCrypto, constants: Dict[str, Any], tmp_path: Path
+) -> None:
+    path: str = str(tmp_path / "wallet.mdb")
+    block_hash: bytes = urandom(32)
+    watch: WatchWallet = WatchWallet(
+        monero_crypto,
+        CheckpointRPC(20, block_hash),
+        constants["PRIVATE_VIEW_KEY"],
+        constants["PUBLIC_SPEND_KEY"],
+        -1,
+        db_path=path,
+    )
+    watch.new_addresses(1, 0, 4)
+
+    outputs: List[OutputInfo] = []
+    for _ in range(100):
+        outputs.append(
+            MoneroOutputInfo(
+                OutputIndex(urandom(32), randint(0, 15)),
+                randint(0, 40),
+                randint(1, 2 ** 40),
+                urandom(32),
+                (randint(0, 1), randint(0, 2)),
+                urandom(32),
+                urandom(32),
+            )
+        )
+        watch.inputs[outputs[-1].index] = outputs[-1]
+        watch.input_index.add(outputs[-1])
+        watch.balances.add(outputs[-1])
+    watch.balances.advance(21)
+
+    # Spend some outputs and reserve others.
+    with watch.reservation_lock:
+        watch.reserve(watch.input_index.select(lambda count: 2 ** 40, 21))
+    spendable: List[Any] = watch.input_index.keys()
+    spent: List[OutputIndex] = [
+        OutputIndex(spendable[k][2], spendable[k][3])
+        for k in range(0, len(spendable), 7)
+    ]
+    watch.settle(spent, None, True)
+
+    with watch.reservation_lock:
+        watch.persist((20, block_hash))
+
+    # Reservations aren't written, so reserved outputs are reloaded as Spendable.
+    expected: Dict[OutputIndex, OutputInfo] = {
+        index: MoneroOutputInfo.from_json(watch.inputs[index].to_json())
+        for index in watch.inputs
+    }
+    for index in expected:
+        if expected[index].state == InputState.Transmitted:
+            expected[index].state = InputState.Spendable
+    keys: List[Any] = sorted(
+        InputIndex.key(expected[index])
+        for index in expected
+        if expected[index].state == InputState.Spendable
+    )
+    unique_factors: Dict[bytes, Any] = dict(watch.unique_factors)
+    balances: List[Balance] = [
+        watch.balance(),
+        watch.balance((1, 2)),
+        watch.account_balance(0),
+        watch.account_balance(1),
+    ]
+    for balance in balances:
+        balance.amounts = [balance.unlocked + balance.pending, balance.locked, 0]
+
+    # Close the database before reopening it.
+    watch.db = None
+    del watch
+
+    # The passed in state is ignored in favor of the database's.
+    reloaded: WatchWallet = WatchWallet(
+        monero_crypto,
+        CheckpointRPC(20, block_hash),
+        constants["PRIVATE_VIEW_KEY"],
+        constants["PUBLIC_SPEND_KEY"],
+        5,
+        db_path=path,
+    )
+    assert reloaded.last_block == 20
+    assert dict(reloaded.inputs) == expected
+    for index in expected:
+        assert reloaded.inputs[index].to_json() == expected[index].to_json()
+    assert reloaded.input_index.keys() == keys
+    assert reloaded.unique_factors == unique_factors
+    assert [
+        reloaded.balance(),
+        reloaded.balance((1, 2)),
+        reloaded.account_balance(0),
+        reloaded.account_balance(1),
+    ] == balances
+
+    # Changes after reloading are still written.
+    first: OutputIndex = next(
+        index
+        for index in expected
+        if reloaded.inputs[index].state == InputState.Spendable
+    )
+    reloaded.settle([first], None, True)
+    reloaded.db = None
+    del reloaded
+
+    reopened: WatchWallet = WatchWallet(
+        monero_crypto,
+        CheckpointRPC(20, block_hash),
+        constants["PRIVATE_VIEW_KEY"],
+        constants["PUBLIC_SPEND_KEY"],
+        -1,
+        db_path=path,
+    )
+    assert reopened.inputs[first].state == InputState.Spent
+    reopened.db = None
+    del reopened
+
+    # If the last scanned Block was reorganized out, the Blocks before it are rescanned.
+    rescanned: WatchWallet = WatchWallet(
+        monero_crypto,
+        CheckpointRPC(20, urandom(32)),
+        constants["PRIVATE_VIEW_KEY"],
+        constants["PUBLIC_SPEND_KEY"],
+        -1,
+    )
+    rescanned.load_db(WalletDB(path), (20, block_hash))
+    assert rescanned.last_block == max(20 - REORG_RESCAN_DEPTH, 0)
+    assert set(rescanned.inputs) == set(expected)